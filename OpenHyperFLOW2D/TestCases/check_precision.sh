@@ -0,0 +1,107 @@
+#!/bin/bash
+#
+# Validation on test cases of
+#   SIMD kernel of max level of CPU (FieldStorage=1) against scalar kernel
+#   (FieldStorage=1, SIMDKernel=0), differences must be 0 with OPTLEVEL=0 build;
+#   batched FillNode2D (FieldStorage=1, isBatchFill=1) against FillNode2D
+#   (FieldStorage=1), differences must be 0 with OPTLEVEL=0 build;
+#   one dt for all subdomains (FieldStorage=1, isGlobalTimeStep=1) against
+#   dt lowered from subdomain to subdomain (FieldStorage=1), differences are 0
+#   if dt isn't lowered during run or field has single subdomain.
+# For every *.dat (except restart *_Res.dat) all runs are made for Nmax
+# iterations (one sync cycle: MonitorIndex=5 with time limit 1e-12 sec),
+# output fields are compared column by column:
+#   max_abs - max |f2 - f1|
+#   max_rel - max |f2 - f1| / max |f1| (relative to column scale)
+#   avg_rel - mean |f2 - f1| / max |f1|
+#
+if [ "$1" == "" ]
+then
+echo "Usage: $0 OpenHyperFLOW2D_binary [Nmax] [dat_files...]"
+exit 1
+fi
+
+BIN=`readlink -f $1`
+NMAX=${2:-2000}
+shift
+shift
+CASES=$@
+
+if [ "$CASES" == "" ]
+then
+CASES=`ls *.dat | grep -v "_Res.dat"`
+fi
+
+WORK_DIR=`pwd`/precision_check
+mkdir -p $WORK_DIR
+
+compare() {
+ TITLE=$1
+ REF_DIR=$WORK_DIR/$PROJECT-$2
+ CMP_DIR=$WORK_DIR/$PROJECT-$3
+
+ echo "$PROJECT (Nmax=$NMAX): $TITLE"
+
+ if [ ! -f $REF_DIR/$PROJECT.plt ] || [ ! -f $CMP_DIR/$PROJECT.plt ]
+ then
+ echo "  no output data, see $WORK_DIR/$PROJECT-*/$PROJECT.log"
+ return
+ fi
+ grep "SIMD kernel" $REF_DIR/$PROJECT.log | head -n1 | sed s/"^"/"  $2: "/
+ grep "SIMD kernel" $CMP_DIR/$PROJECT.log | head -n1 | sed s/"^"/"  $3: "/
+ grep "Step No" $REF_DIR/$PROJECT.log | tail -n1 | sed s/"^"/"  $2: "/
+ grep "Step No" $CMP_DIR/$PROJECT.log | tail -n1 | sed s/"^"/"  $3: "/
+
+ awk -v REF=$REF_DIR/$PROJECT.plt '
+ BEGIN {
+   getline HDR < REF
+   sub("#VARIABLES = ","",HDR)
+   NV = split(HDR,VAR,", ")
+ }
+ /^[-0-9.]/ {
+   if((getline LINE < REF) <= 0) exit
+   while(LINE !~ /^[-0-9.]/)
+      if((getline LINE < REF) <= 0) exit
+   split(LINE,R," ")
+   NP++
+   for(k=3;k<=NF;k++) {
+       d = $k - R[k]; if(d < 0) d = -d
+       r = R[k];      if(r < 0) r = -r
+       if(d > DMAX[k]) DMAX[k] = d
+       DSUM[k] += d
+       if(r > RMAX[k]) RMAX[k] = r
+   }
+ }
+ END {
+   printf("  %-10s %14s %14s %14s\n","Variable","max_abs","max_rel","avg_rel")
+   for(k=3;k<=NV;k++)
+       printf("  %-10s %14.6e %14.6e %14.6e\n",VAR[k],DMAX[k],
+              (RMAX[k] > 0 ? DMAX[k]/RMAX[k] : 0),(RMAX[k] > 0 ? DSUM[k]/NP/RMAX[k] : 0))
+ }' $CMP_DIR/$PROJECT.plt
+}
+
+for DAT in $CASES
+do
+ PROJECT=`grep "<data/ProjectName=" $DAT | sed s/".*ProjectName="/""/ | sed s/">.*"/""/`
+
+ for RUN in double:1:9:0:0 scalar:1:0:0:0 batch:1:9:1:0 globaldt:1:9:0:1
+ do
+  TAG=`echo $RUN | cut -d: -f1`
+  FST=`echo $RUN | cut -d: -f2`
+  SIMD=`echo $RUN | cut -d: -f3`
+  BATCH=`echo $RUN | cut -d: -f4`
+  GDT=`echo $RUN | cut -d: -f5`
+  RUN_DIR=$WORK_DIR/$PROJECT-$TAG
+  rm -rf $RUN_DIR
+  mkdir -p $RUN_DIR
+  sed -e "s/<data\/Nmax=[0-9]*>/<data\/Nmax=$NMAX>/" \
+      -e "s/<data\/MonitorIndex=[0-9]*>/<data\/MonitorIndex=5>/" \
+      -e "s/<data\/ExitMonitorValue=[^>]*>/<data\/ExitMonitorValue=1e-12>/" \
+      -e "s/^\(<data\/ProjectName=.*\)$/\1\n<data\/FieldStorage=$FST>\n<data\/SIMDKernel=$SIMD>\n<data\/isBatchFill=$BATCH>\n<data\/isGlobalTimeStep=$GDT>/" $DAT > $RUN_DIR/$DAT
+  (cd $RUN_DIR && $BIN $DAT > $PROJECT.log 2>&1)
+ done
+
+ compare "SIMD kernel vs scalar kernel (FieldStorage=1)" scalar double
+ compare "batched FillNode2D vs FillNode2D (FieldStorage=1)" double batch
+ compare "one dt vs dt of subdomains (FieldStorage=1)" double globaldt
+done
@@ -0,0 +1,74 @@
+#!/bin/bash
+#
+# Restart check: GlobalTime (node (0,0) of cold side-table) must survive
+# save and load of swap files.
+# For every *.dat (except restart *_Res.dat) two runs are made in the same
+# directory for Nmax iterations (one sync cycle: MonitorIndex=5 with time
+# limit 1e-12 sec):
+#   1st run - starts without swap files, saves <project>.hf2d and
+#             <project>.hf2d.cold, saved time is read from .cold file
+#   2nd run - restarts from swap files, reported restart time must be
+#             equal to saved time (FP=double)
+#
+if [ "$1" == "" ]
+then
+echo "Usage: $0 OpenHyperFLOW2D_binary [Nmax] [dat_files...]"
+exit 1
+fi
+
+BIN=`readlink -f $1`
+NMAX=${2:-100}
+shift
+shift
+CASES=$@
+
+if [ "$CASES" == "" ]
+then
+CASES=`ls *.dat | grep -v "_Res.dat"`
+fi
+
+WORK_DIR=`pwd`/restart_check
+mkdir -p $WORK_DIR
+ERRORS=0
+
+for DAT in $CASES
+do
+ PROJECT=`grep "<data/ProjectName=" $DAT | sed s/".*ProjectName="/""/ | sed s/">.*"/""/`
+ RUN_DIR=$WORK_DIR/$PROJECT
+ rm -rf $RUN_DIR
+ mkdir -p $RUN_DIR
+ sed -e "s/<data\/Nmax=[0-9]*>/<data\/Nmax=$NMAX>/" \
+     -e "s/<data\/NOutStep=[0-9]*>/<data\/NOutStep=$NMAX>/" \
+     -e "s/<data\/MonitorIndex=[0-9]*>/<data\/MonitorIndex=5>/" \
+     -e "s/<data\/ExitMonitorValue=[^>]*>/<data\/ExitMonitorValue=1e-12>/" \
+     -e "s/<data\/InitTime=[^>]*>/<data\/InitTime=0.>/" $DAT > $RUN_DIR/$DAT
+ (cd $RUN_DIR && $BIN $DAT > $PROJECT-1.log 2>&1)
+
+ if [ ! -f $RUN_DIR/$PROJECT.hf2d.cold ]
+ then
+ echo "$PROJECT: FAILED - no cold swap file, see $RUN_DIR/$PROJECT-1.log"
+ ERRORS=$((ERRORS+1))
+ continue
+ fi
+ SAVED=`od -A n -t f8 -N 8 $RUN_DIR/$PROJECT.hf2d.cold | tr -d " "`
+
+ (cd $RUN_DIR && $BIN $DAT > $PROJECT-2.log 2>&1)
+ LOADED=`grep "Restart from swap file" $RUN_DIR/$PROJECT-2.log | head -n1 | sed s/".* at time "/""/ | sed s/" sec.*"/""/`
+
+ if [ "$LOADED" == "" ]
+ then
+ echo "$PROJECT: FAILED - no restart, see $RUN_DIR/$PROJECT-2.log"
+ ERRORS=$((ERRORS+1))
+ continue
+ fi
+
+ if awk -v s=$SAVED -v l=$LOADED 'BEGIN { d = s - l; if(d < 0) d = -d; exit !(s > 0 && d <= 1e-5*s) }'
+ then
+ echo "$PROJECT: OK (saved time $SAVED sec, restart time $LOADED sec)"
+ else
+ echo "$PROJECT: FAILED (saved time $SAVED sec, restart time $LOADED sec)"
+ ERRORS=$((ERRORS+1))
+ fi
+done
+
+exit $ERRORS
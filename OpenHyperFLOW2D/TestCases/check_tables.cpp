@@ -0,0 +1,126 @@
+/*******************************************************************************
+*   OpenHyperFLOW2D                                                            *
+*                                                                              *
+*   Check of merged property tables (see check_tables.sh):                     *
+*   TableSet::GetVal() must be equal to Table::GetVal() bit by bit             *
+*                                                                              *
+*   Copyright policy: LGPL V3                                                  *
+*   http://github.com/sergeas67/openhyperflow2d                                *
+*******************************************************************************/
+#include "obj_data/obj_data.hpp"
+#include <math.h>
+
+#define NUM_TABLES  12
+#define NUM_SWEEP   200000
+
+static const char* TableName[NUM_TABLES] = {
+                   "Cp_Fuel",  "Cp_OX",  "Cp_cp",  "Cp_air",
+                   "lam_Fuel", "lam_OX", "lam_cp", "lam_air",
+                   "mu_Fuel",  "mu_OX",  "mu_cp",  "mu_air"
+};
+
+static Table*        T[NUM_TABLES];
+static long          NumErr[NUM_TABLES];
+static FP            MaxErr[NUM_TABLES];
+static FP            MaxErrX[NUM_TABLES];
+static long          NumPoints;
+
+// Compare all tables at x (hint - merged grid interval of caller or NULL)
+static void CheckPoint(TableSet* ts, FP x, unsigned int* hint) {
+    FP           v[NUM_TABLES];
+    unsigned int k;
+
+    ts->GetVal(x,v,NUM_TABLES,hint);
+    k = ts->GetInterval(x);
+
+    for ( int t=0; t<NUM_TABLES; t++ ) {
+        FP y = T[t]->GetVal(x);
+        if ( v[t] != y || ts->GetVal(x,k,t) != y ) {
+            FP e = fabs(v[t] - y) > fabs(ts->GetVal(x,k,t) - y) ? fabs(v[t] - y) : fabs(ts->GetVal(x,k,t) - y);
+            NumErr[t]++;
+            if ( NumErr[t] == 1 || e > MaxErr[t] ) {
+                MaxErr[t]  = e;
+                MaxErrX[t] = x;
+            }
+        }
+    }
+    NumPoints++;
+}
+
+int main(int argc, char** argv) {
+    InputData*   Data;
+    TableSet*    ts;
+    unsigned int hint = 0;
+    FP           x_min, x_max, dx, x;
+    int          t, i, n_err = 0;
+
+    if ( argc < 2 ) {
+        printf("Usage: %s dat_file\n",argv[0]);
+        return 1;
+    }
+
+    Data = new InputData(argv[1],DS_FILE,&cout);
+
+    if ( Data->GetDataError() != 0 ) {
+        printf("%s: input data error\n",argv[1]);
+        return 1;
+    }
+
+    for ( t=0; t<NUM_TABLES; t++ ) {
+        T[t] = Data->GetTable((char*)TableName[t]);
+        if ( T[t] == NULL ) {
+            printf("%s: table %s not found\n",argv[1],TableName[t]);
+            return 1;
+        }
+    }
+
+    ts = new TableSet(T,NUM_TABLES);
+
+    x_min = x_max = 0.;
+    for ( t=0, i=0; t<NUM_TABLES; t++ ) {
+        for ( unsigned int j=0; j<T[t]->n; j++, i++ ) {
+            if ( i == 0 || T[t]->x[j] < x_min ) x_min = T[t]->x[j];
+            if ( i == 0 || T[t]->x[j] > x_max ) x_max = T[t]->x[j];
+        }
+    }
+
+    // Every table point, its neighbour FP numbers and midpoints to next points of all tables
+    for ( t=0; t<NUM_TABLES; t++ ) {
+        for ( unsigned int j=0; j<T[t]->n; j++ ) {
+            x = T[t]->x[j];
+            CheckPoint(ts,x,NULL);
+            CheckPoint(ts,nextafter(x,x_min-1.),NULL);
+            CheckPoint(ts,nextafter(x,x_max+1.),NULL);
+            for ( int s=0; s<NUM_TABLES; s++ )
+                for ( unsigned int l=0; l<T[s]->n; l++ )
+                    CheckPoint(ts,0.5*(x+T[s]->x[l]),NULL);
+        }
+    }
+
+    // Dense sweep beyond both ends, up and down with hint
+    dx = (x_max - x_min)*2./NUM_SWEEP;
+    for ( i=0; i<=NUM_SWEEP; i++ )
+        CheckPoint(ts,x_min - 0.5*(x_max - x_min) + i*dx,&hint);
+    for ( i=NUM_SWEEP; i>=0; i-- )
+        CheckPoint(ts,x_min - 0.5*(x_max - x_min) + i*dx,&hint);
+
+    // Jumps with hint and far beyond both ends
+    for ( i=0; i<=NUM_SWEEP; i++ )
+        CheckPoint(ts,x_min - 0.5*(x_max - x_min) + ((i*7919L)%(NUM_SWEEP+1))*dx,&hint);
+    CheckPoint(ts,x_min - 1.e6,&hint);
+    CheckPoint(ts,x_max + 1.e6,&hint);
+
+    for ( t=0; t<NUM_TABLES; t++ ) {
+        if ( NumErr[t] ) {
+            printf("%s: %s FAILED - %ld of %ld points differ, max difference %g at x=%.17g\n",
+                   argv[1],TableName[t],NumErr[t],NumPoints,MaxErr[t],MaxErrX[t]);
+            n_err++;
+        }
+    }
+
+    if ( n_err == 0 )
+        printf("%s: OK (%d tables, %ld points, x=%g...%g)\n",argv[1],NUM_TABLES,NumPoints,x_min,x_max);
+
+    delete ts;
+    return n_err;
+}
@@ -0,0 +1,47 @@
+#!/bin/bash
+#
+# Merged property tables check: TableSet::GetVal() (mixture Cp, lam, mu of
+# fuel, OX, combustion products and air) must be equal to Table::GetVal()
+# bit by bit. Checker check_tables.cpp is built with obj_data sources (FP=double,
+# CXX and CXXFLAGS from environment, default g++ -O2).
+# For every *.dat (except restart *_Res.dat) tables are compared at
+#   every table point, its neighbour FP numbers and midpoints to all
+#   other table points (without hint);
+#   dense sweep up and down from x_min - (x_max - x_min)/2 to
+#   x_max + (x_max - x_min)/2 and jumps in this range (with hint);
+#   x_min - 1e6 and x_max + 1e6.
+#
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--O2}
+SRC_DIR=`dirname $(readlink -f $0)`
+CASES=$@
+
+if [ "$CASES" == "" ]
+then
+CASES=`ls *.dat | grep -v "_Res.dat"`
+fi
+
+WORK_DIR=`pwd`/tables_check
+mkdir -p $WORK_DIR
+
+$CXX $CXXFLAGS -DFP=double -D_STREAM_COMPAT -Wno-deprecated -I$SRC_DIR/.. -I$SRC_DIR/../obj_data -I$SRC_DIR/../utl \
+     -o $WORK_DIR/check_tables $SRC_DIR/check_tables.cpp $SRC_DIR/../obj_data/obj_data.cpp $SRC_DIR/../utl/utl.cpp \
+     > $WORK_DIR/build.log 2>&1
+
+if [ ! -x $WORK_DIR/check_tables ]
+then
+echo "FAILED - can't build checker, see $WORK_DIR/build.log"
+exit 1
+fi
+
+ERRORS=0
+
+for DAT in $CASES
+do
+ if ! $WORK_DIR/check_tables $DAT
+ then
+ ERRORS=$((ERRORS+1))
+ fi
+done
+
+exit $ERRORS
@@ -42,6 +42,11 @@ then
 SIMD=AVX2
 fi
 
+if [ "$FLAG" == "avx512f" ]
+then
+SIMD=AVX512
+fi
+
 
 done
 echo -e $SIMD
\ No newline at end of file
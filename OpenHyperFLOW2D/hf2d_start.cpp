@@ -19,6 +19,7 @@ int rank;
 int last_rank;
 UArray< UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* >* ArraySubDomain  = NULL;
 FP  x0;
+FP  y0_local;                 // y of first row of subdomain (y0() is libm function)
 #endif // _MPI
 
 SolverMode    ProblemType;
@@ -35,7 +36,7 @@ int main( int argc, char **argv )
     static char    inFile[256];
 #ifdef _MPI
     FlowNode2D<FP,NUM_COMPONENTS>* TmpMatrixPtr;
-    int TmpMaxX;
+    int TmpMaxX, TmpMaxY;
     UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >*            TmpSubDomain    = NULL;
     UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >*        TmpCoreSubDomain= NULL;
 #endif // _MPI
@@ -62,8 +63,12 @@ int main( int argc, char **argv )
 #else
             printf(" (parallel OpenMP version)\n");
 #endif // OPEN_MP
+#else
+#ifdef _OPENMP
+            printf("(parallel MPI+OpenMP version)\n");
 #else
             printf("(parallel MPI version)\n");
+#endif // _OPENMP
 #endif // _MPI
             printf("Copyright (C) 1995-2016 by Serge A. Suchkov\nCopyright policy: LGPL V3\nUsage: %s [{input_data_file}]\n",argv[0]);
 
@@ -73,11 +78,17 @@ int main( int argc, char **argv )
 #else
             printf("non-uniform mesh");
 #endif //_UNIFORM_MESH_
-            printf("\n\n\tFlowNode2D size = %d bytes\n\n",(int)(sizeof(FlowNode2D<FP,NUM_COMPONENTS>)));
+            printf("\n\n\tFlowNode2D size = %d bytes\n",(int)(sizeof(FlowNode2D<FP,NUM_COMPONENTS>)));
+            printf("\tFlowNodeCold2D size = %d bytes\n\n",(int)(sizeof(FlowNodeCold2D<FP,NUM_COMPONENTS>)));
             exit(0);
         } else {
 #ifdef _MPI
+#ifdef _OPENMP
+            // MPI is called by master thread only (outside of parallel regions)
+            MPI::Init_thread(argc, argv, MPI::THREAD_FUNNELED);
+#else
             MPI::Init(argc, argv);
+#endif // _OPENMP
 rank      = MPI::COMM_WORLD.Get_rank();
 #endif // _MPI
             sprintf(inFile,"%s",argv[1]);
@@ -124,12 +135,12 @@ rank      = MPI::COMM_WORLD.Get_rank();
 
  #ifndef     _PARALLEL_RECALC_Y_PLUS_
                    *o_stream << "\nSerial calc min distance to wall..." << flush;
-                   SetMinDistanceToWall2D(J,WallNodes);
+                   SetMinDistanceToWall2D(J,ColdJ,WallNodes);
                    *o_stream << "OK\n" << flush;
-                   Recalc_y_plus(J,WallNodes);                        // Calculate initial y+ value         
+                   Recalc_y_plus(J,ColdJ,WallNodes);                        // Calculate initial y+ value         
                    
                    if(!PreloadFlag)
-                      SetInitBoundaryLayer(J,delta_bl);               // Set Initial boundary layer profile
+                      SetInitBoundaryLayer(J,ColdJ,delta_bl);               // Set Initial boundary layer profile
  #else
                    *o_stream << "\nParallel calc min distance to wall..." << endl;
                    
@@ -139,85 +150,93 @@ rank      = MPI::COMM_WORLD.Get_rank();
                    *o_stream << "\nSolver Mode: Euler/FP" << 8*sizeof(FP) <<"\n" << endl;
                }
                
+               BcastSubDomains2D(rank);                            // Blocks of process grid -> all ranks
+
                TmpMatrixPtr=J->GetMatrixPtr();
-               int SubStartIndex, SubMaxX,
+               int SubStartIndex, SubStartY,
                             r_Overlap=0,
-                            l_Overlap=0;
+                            l_Overlap=0,
+                            u_Overlap=0,
+                            d_Overlap=0;
                *o_stream << "Allocate SubDomain:\n";
-               SubStartIndex = 0;
                
-               for (unsigned int i=0;i<GlobalSubDomain->GetNumElements();i++) {
-                   SubStartIndex = GlobalSubDomain->GetElementPtr(i)->GetX();  
-                   SubMaxX = GlobalSubDomain->GetElementPtr(i)->GetY();
-               if(i == GlobalSubDomain->GetNumElements()-1)
-                 r_Overlap = 0;
-               else
-                 r_Overlap = 1; 
-               if(i == 0)
-                 l_Overlap = 0;
-               else
-                 l_Overlap = 1; 
+               for (int i=0;i<last_rank+1;i++) {
+                   Block2D b;
 
-               TmpMaxX = (SubMaxX-SubStartIndex)+r_Overlap;
-               TmpMatrixPtr = (FlowNode2D<FP,NUM_COMPONENTS>*)((ulong)J->GetMatrixPtr()+(ulong)(sizeof(FlowNode2D<FP,NUM_COMPONENTS>)*(SubStartIndex)*MaxY));                      
+                   GetBlock2D(i,&b);
+                   l_Overlap = HaloDepth*(b.left  != MPI::PROC_NULL);
+                   r_Overlap = HaloDepth*(b.right != MPI::PROC_NULL);
+                   d_Overlap = HaloDepth*(b.down  != MPI::PROC_NULL);
+                   u_Overlap = HaloDepth*(b.up    != MPI::PROC_NULL);
+
+                   SubStartIndex = b.i_start-l_Overlap;
+                   SubStartY     = b.j_start-d_Overlap;
+                   TmpMaxX = b.i_end+r_Overlap-SubStartIndex;
+                   TmpMaxY = b.j_end+u_Overlap-SubStartY;
+                   TmpMatrixPtr = (FlowNode2D<FP,NUM_COMPONENTS>*)((ulong)J->GetMatrixPtr()+(ulong)(sizeof(FlowNode2D<FP,NUM_COMPONENTS>)*(SubStartIndex)*MaxY));                      
                
-               x0 = SubStartIndex*FlowNode2D<FP,NUM_COMPONENTS>::dx;
+                   x0 = SubStartIndex*FlowNode2D<FP,NUM_COMPONENTS>::dx;
+                   y0_local = SubStartY*FlowNode2D<FP,NUM_COMPONENTS>::dy;
                
-               *o_stream << "SubDomain("<<i<<")[" << TmpMaxX << "x" << MaxY << "]  Size=" << (ulong)(sizeof(FlowNode2D<FP,NUM_COMPONENTS>)*TmpMaxX*MaxY)/(1024*1024) << " Mb\n"; 
-               TmpSubDomain = new UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >(TmpMatrixPtr,TmpMaxX,MaxY);
+                   *o_stream << "SubDomain("<<i<<")[" << TmpMaxX << "x" << TmpMaxY << "]  Size=" << (ulong)(sizeof(FlowNode2D<FP,NUM_COMPONENTS>)*TmpMaxX*TmpMaxY)/(1024*1024) << " Mb\n"; 
+                   TmpSubDomain = new UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >(TmpMatrixPtr,TmpMaxX,MaxY);   // columns of block in J
                
-               if(ProblemType == SM_NS) {
+                   if(ProblemType == SM_NS && SubStartY == 0) {
 #ifdef _PARALLEL_RECALC_Y_PLUS_
-                  SetMinDistanceToWall2D(TmpSubDomain,WallNodes,x0);
+                      UMatrix2D< FlowNodeCold2D<FP,NUM_COMPONENTS> > TmpColdSubDomain(ColdJ->GetMatrixPtr()+SubStartIndex*MaxY,TmpMaxX,MaxY);
+                      SetMinDistanceToWall2D(TmpSubDomain,&TmpColdSubDomain,WallNodes,x0);   // columns of block in ColdJ
 #endif // _PARALLEL_RECALC_Y_PLUS_
-               }
+                   }
 
-               ArraySubDomain->AddElement(&TmpSubDomain);
-               o_stream->flush();
+                   ArraySubDomain->AddElement(&TmpSubDomain);
+                   o_stream->flush();
                
-               if(i>0) {
-                  MPI::COMM_WORLD.Send(&MaxY,1,MPI::INT,i,tag_MaxY);
-                  MPI::COMM_WORLD.Send(&TmpMaxX,1,MPI::INT,i,tag_MaxX);
-#ifdef _IMPI_
-                  LongMatrixSend(i, TmpSubDomain->GetMatrixPtr(), TmpSubDomain->GetMatrixSize());// Low Mem Send subdomain
-#else
-                  MPI::COMM_WORLD.Send(TmpSubDomain->GetMatrixPtr(),
-                                       TmpSubDomain->GetMatrixSize(),
-                                       MPI::BYTE,i,tag_Matrix); 
-#endif // _IMPI_
+                   if(i>0) {
+                      MPI::COMM_WORLD.Send(&TmpMaxY,1,MPI::INT,i,tag_MaxY);
+                      MPI::COMM_WORLD.Send(&TmpMaxX,1,MPI::INT,i,tag_MaxX);
+                      SendBlock2D(i,TmpMatrixPtr+SubStartY,TmpMaxX,TmpMaxY,MaxY,                        // Send subdomain
+                                  sizeof(FlowNode2D<FP,NUM_COMPONENTS>),tag_Matrix);
+                      SendBlock2D(i,ColdJ->GetMatrixPtr()+SubStartIndex*MaxY+SubStartY,                // Send cold side-table of subdomain
+                                  TmpMaxX,TmpMaxY,MaxY,sizeof(FlowNodeCold2D<FP,NUM_COMPONENTS>),tag_ColdMatrix);
                   
-                  if(ProblemType == SM_NS) {
-                     MPI::COMM_WORLD.Send(&NumWallNodes,1,MPI::INT,i,tag_NumWallNodes);           // Send wall nodes array size
-                     MPI::COMM_WORLD.Send(WallNodes->GetArrayPtr(),NumWallNodes*sizeof(XY<int>),  // Send wall nodes array
-                                           MPI::BYTE,i,tag_WallNodesArray);
-                  }
+                      if(ProblemType == SM_NS) {
+                         MPI::COMM_WORLD.Send(&NumWallNodes,1,MPI::INT,i,tag_NumWallNodes);           // Send wall nodes array size
+                         MPI::COMM_WORLD.Send(WallNodes->GetArrayPtr(),NumWallNodes*sizeof(XY<int>),  // Send wall nodes array
+                                               MPI::BYTE,i,tag_WallNodesArray);
+                      }
 
-                  MPI::COMM_WORLD.Send(&x0,1,MPI::DOUBLE,i,tag_X0);                               // Send x0 for SubDomain
-                }
-               if(MonitorPointsArray) {
-                   for(int ii_monitor=0;ii_monitor<(int)MonitorPointsArray->GetNumElements();ii_monitor++) {
-                           if(MonitorPointsArray->GetElement(ii_monitor).MonitorXY.GetX() >= x0 &&
-                              MonitorPointsArray->GetElement(ii_monitor).MonitorXY.GetX() < x0 + FlowNode2D<FP,NUM_COMPONENTS>::dx*TmpSubDomain->GetX()) {
-                              MonitorPointsArray->GetElement(ii_monitor).rank = i; 
-                           }
+                      MPI::COMM_WORLD.Send(&x0,1,MPI::DOUBLE,i,tag_X0);                               // Send x0, y0 for SubDomain
+                      MPI::COMM_WORLD.Send(&y0_local,1,MPI::DOUBLE,i,tag_Y0);
+                   }
+                   if(MonitorPointsArray) {
+                       // monitor point belongs to rank of its node (own nodes of block, not halo)
+                       for(int ii_monitor=0;ii_monitor<(int)MonitorPointsArray->GetNumElements();ii_monitor++) {
+                               int i_i = (MonitorPointsArray->GetElement(ii_monitor).MonitorXY.GetX() - x0 - FlowNode2D<FP,NUM_COMPONENTS>::dx*0.5)/FlowNode2D<FP,NUM_COMPONENTS>::dx;
+                               int j_j = (MonitorPointsArray->GetElement(ii_monitor).MonitorXY.GetY() - y0_local)/FlowNode2D<FP,NUM_COMPONENTS>::dy;
+                               if(MonitorPointsArray->GetElement(ii_monitor).MonitorXY.GetX() >= x0 &&
+                                  MonitorPointsArray->GetElement(ii_monitor).MonitorXY.GetY() >= y0_local &&
+                                  i_i >= (int)l_Overlap && i_i < (int)(l_Overlap+b.i_end-b.i_start) &&
+                                  j_j >= (int)d_Overlap && j_j < (int)(d_Overlap+b.j_end-b.j_start)) {
+                                  MonitorPointsArray->GetElement(ii_monitor).rank = i; 
+                               }
+                       }
                    }
                }
-           }
-           TmpMaxX      = ArraySubDomain->GetElement(0)->GetX();
-           MaxY         = ArraySubDomain->GetElement(0)->GetY();
-           TmpSubDomain = ArraySubDomain->GetElement(0);
+               TmpMaxX      = ArraySubDomain->GetElement(0)->GetX();
+               TmpMaxY      = ArraySubDomain->GetElement(0)->GetY();                             // rank 0 - whole columns of J
+               TmpSubDomain = ArraySubDomain->GetElement(0);
+               x0 = y0_local = 0.;
         } else {
-           
-           MPI::COMM_WORLD.Recv(&MaxY,1,MPI::INT,0,tag_MaxY);
+           BcastSubDomains2D(rank);
+           MPI::COMM_WORLD.Recv(&TmpMaxY,1,MPI::INT,0,tag_MaxY);
            MPI::COMM_WORLD.Recv(&TmpMaxX,1,MPI::INT,0,tag_MaxX);
-           TmpSubDomain = new UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >(TmpMaxX,MaxY);
-#ifdef _IMPI_
-             LongMatrixRecv(0,TmpSubDomain->GetMatrixPtr(),TmpSubDomain->GetMatrixSize());
-#else
-             MPI::COMM_WORLD.Recv(TmpSubDomain->GetMatrixPtr(),
-                                  TmpSubDomain->GetMatrixSize(),
-                                  MPI::BYTE,0,tag_Matrix);
-#endif // _IMPI_
+           TmpSubDomain = new UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >(TmpMaxX,TmpMaxY);
+           RecvBlock2D(0,TmpSubDomain->GetMatrixPtr(),TmpMaxX,TmpMaxY,TmpMaxY,                        // Block is received to compact matrix
+                       sizeof(FlowNode2D<FP,NUM_COMPONENTS>),tag_Matrix);
+             ColdJ = CreateColdTable2D(TmpSubDomain);                                                    // Cold side-table of subdomain
+             MPI::COMM_WORLD.Recv(ColdJ->GetMatrixPtr(),
+                                  ColdJ->GetMatrixSize(),
+                                  MPI::BYTE,0,tag_ColdMatrix);
              if(ProblemType == SM_NS) {
                  MPI::COMM_WORLD.Recv(&NumWallNodes,1,MPI::INT,0,tag_NumWallNodes);                      // Recive wall nodes array size
                  WallNodes = new UArray< XY<int> >(NumWallNodes,-1);                                     // Create wall nodes array
@@ -226,7 +245,8 @@ rank      = MPI::COMM_WORLD.Get_rank();
                  WallNodesUw_2D = new UArray<FP>(NumWallNodes,-1);                                       // Create friction velosity array
              }
 
-             MPI::COMM_WORLD.Recv(&x0,1,MPI::DOUBLE,0,tag_X0);                                           // Recive x0 for SubDomain
+             MPI::COMM_WORLD.Recv(&x0,1,MPI::DOUBLE,0,tag_X0);                                           // Recive x0, y0 for SubDomain
+             MPI::COMM_WORLD.Recv(&y0_local,1,MPI::DOUBLE,0,tag_Y0);
        }
         
         if(MonitorPointsArray && 
@@ -241,12 +261,34 @@ rank      = MPI::COMM_WORLD.Get_rank();
 
         
         MPI::COMM_WORLD.Barrier();
-        TmpCoreSubDomain = new UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >(TmpMaxX,MaxY);
+        TmpCoreSubDomain = new UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >(TmpMaxX,TmpMaxY);
+        {
+            // NUMA node of rank, its field/core memory and OpenMP threads of rank
+            int  rank_node[4];
+            int* nodes = (rank == 0) ? new int[4*(last_rank+1)] : NULL;
+
+            rank_node[0] = GetThreadNode2D();
+            rank_node[1] = GetPageNode2D(TmpSubDomain->GetMatrixPtr()+TmpMaxX*TmpMaxY/2);
+            rank_node[2] = GetPageNode2D(TmpCoreSubDomain->GetMatrixPtr()+TmpMaxX*TmpMaxY/2);
+#ifdef _OPENMP
+            rank_node[3] = omp_get_max_threads();
+#else
+            rank_node[3] = 1;
+#endif // _OPENMP
+            MPI::COMM_WORLD.Gather(rank_node,4,MPI::INT,nodes,4,MPI::INT,0);
+            if(rank == 0) {
+                for(int ii = 0; ii < last_rank + 1; ii++ )
+                    *o_stream << "Rank " << ii << ": node " << nodes[4*ii] << ", " << nodes[4*ii+3] << " thread(s), field pages on node "
+                              << nodes[4*ii+1] << ", core pages on node " << nodes[4*ii+2] << "\n";
+                o_stream->flush();
+                delete[] nodes;
+            }
+        }
         
 #ifdef _PARALLEL_RECALC_Y_PLUS_
         if(ProblemType == SM_NS) {
             if(!PreloadFlag)
-               SetInitBoundaryLayer(TmpSubDomain,delta_bl);                                               // Set Initial boundary layer linear profile
+               SetInitBoundaryLayer(TmpSubDomain,ColdJ,delta_bl);                                               // Set Initial boundary layer linear profile
             if( rank == 0 ) {
                 if(WallNodes && !WallNodesUw_2D && J) 
                     WallNodesUw_2D = GetWallFrictionVelocityArray2D(J,WallNodes);
@@ -263,7 +305,7 @@ rank      = MPI::COMM_WORLD.Get_rank();
                                          WallNodesUw_2D->GetNumElements()*WallNodesUw_2D->GetElementSize(),
                                          MPI::BYTE,0,tag_WallFrictionVelocity);
             }
-          ParallelRecalc_y_plus(TmpSubDomain,WallNodes,WallNodesUw_2D,x0);
+          ParallelRecalc_y_plus(TmpSubDomain,ColdJ,WallNodes,WallNodesUw_2D,x0,y0_local);
         }
 #endif // _PARALLEL_RECALC_Y_PLUS_
      
@@ -285,7 +327,7 @@ rank      = MPI::COMM_WORLD.Get_rank();
         DEEPS2D_Run((ofstream*)o_stream, 
                       TmpSubDomain,
                       TmpCoreSubDomain,
-                      rank, last_rank, x0);
+                      rank, last_rank, x0, y0_local);
 //------------------------- MPI version ------------------------------------
 #else
 //---------------------- OpenMP/Single thread version ----------------------
@@ -295,38 +337,23 @@ rank      = MPI::COMM_WORLD.Get_rank();
        if(ProblemType == SM_NS) {
            // Scan area for seek wall nodes
            WallNodes = GetWallNodes((ofstream*)o_stream,J,Data->GetIntVal((char*)"isVerboseOutput")); 
-           SetMinDistanceToWall2D(J,WallNodes);
-           Recalc_y_plus(J,WallNodes);                        // Calculate initial y+ value
+           SetMinDistanceToWall2D(J,ColdJ,WallNodes);
+           Recalc_y_plus(J,ColdJ,WallNodes);                        // Calculate initial y+ value
            
            if(!PreloadFlag)
-              SetInitBoundaryLayer(J,delta_bl);               // Set Initial boundary layer profile
+              SetInitBoundaryLayer(J,ColdJ,delta_bl);               // Set Initial boundary layer profile
        }
-       UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* TmpSubDomain=NULL;
-       UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >* TmpCoreSubDomain=NULL;
-       FlowNode2D<FP,NUM_COMPONENTS>* TmpMatrixPtr=J->GetMatrixPtr();
-       int SubStartIndex, Overlap, SubMaxX;
        *o_stream << "Allocate SubDomain:\n";
        
-       for (unsigned int i=0;i<GlobalSubDomain->GetNumElements();i++) {
-            SubStartIndex = GlobalSubDomain->GetElementPtr(i)->GetX();  
-            SubMaxX = GlobalSubDomain->GetElementPtr(i)->GetY();
-            if(i == GlobalSubDomain->GetNumElements()-1)
-               Overlap = 0;
-            else
-               Overlap = 1;
-            TmpMatrixPtr=(FlowNode2D<FP,NUM_COMPONENTS>*)((ulong)J->GetMatrixPtr()+(ulong)(sizeof(FlowNode2D<FP,NUM_COMPONENTS>)*SubStartIndex*MaxY));
-            TmpSubDomain     = new UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >(TmpMatrixPtr,(SubMaxX-SubStartIndex)+Overlap,MaxY);
-            TmpCoreSubDomain = new UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >((SubMaxX-SubStartIndex)+Overlap,MaxY);
-            SubDomainArray->AddElement(&TmpSubDomain);
-            CoreSubDomainArray->AddElement(&TmpCoreSubDomain);
-           }
-       SubStartIndex = 0;
+       PinThreads2D((ofstream*)o_stream);                 // Pin threads (if isThreadPinning)
+       SetSubDomains2D(GlobalSubDomain);                  // Views of J and core matrices of SubDomains
        for(unsigned int i=0;i<SubDomainArray->GetNumElements();i++) {
           *o_stream << "SubDomain(" << i << ")[" << SubDomainArray->GetElement(i)->GetX() << "x" << \
           SubDomainArray->GetElement(i)->GetY() << "] Size= " << SubDomainArray->GetElement(i)->GetMatrixSize()/(1024*1024) << "+" \
           << CoreSubDomainArray->GetElement(i)->GetMatrixSize()/(1024*1024) << " Mb\n"; 
            o_stream->flush();
           }
+       PrintPlacement2D((ofstream*)o_stream);
        *o_stream << "\nStart computation...\n" << flush;
        o_stream->flush();
        DEEPS2D_Run((ofstream*)o_stream);
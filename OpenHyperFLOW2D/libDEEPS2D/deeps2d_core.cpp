@@ -12,10 +12,12 @@
 *  last update: 07/04/2016                                                     *
 ********************************************************************************/
 #include "deeps2d_core.hpp"
+#include "deeps2d_kernel.hpp"
 
 #include <sys/time.h>
 #include <sys/timeb.h>
 #include <sys/file.h>
+#include <pthread.h>
 
 int NumContour;
 int start_iter = 5;
@@ -30,10 +32,36 @@ int            err_i, err_j;
 int            turb_mod_name_index = 0;
 int            isAlternateRMS;
 int            isIgnoreUnsetNodes;
+int            FieldStorage;
+int            SIMDKernel;
+int            isFusedSweep;
+int            isBatchFill;
+int            isGlobalTimeStep;   // one dt for all subdomains in iteration (OpenMP version)
+int            NumSpeciesEq;       // number of solved species equations (0 or NUM_COMPONENTS)
+int            TemporalBlock;
+int            TileX, TileY;       // tile size of task-based sweep (TileX=0 - one subdomain per thread)
+int            RebalanceStep;      // outer cycles between rebalancing of subdomains by measured cost (MPI - saving of cost for next start, 0 - off)
+int            isThreadPinning;    // pin OpenMP threads to CPUs
+int            isNUMAPlacement;    // place memory of subdomain on NUMA node of its thread
+int            AsyncOutput;        // snapshot buffers of asynchronous output (0 - synchronous output)
+#ifdef _MPI
+int            isPackedHalo;       // halo exchange sends only node fields read by sweep
+int            isHaloOverlap;      // halo exchange is in flight during sweep of interior nodes
+int            HaloDepth;          // halo columns/rows of rank, exchanged every HaloDepth iterations
+#endif // _MPI
+FlowFieldSoA2D<FP,NUM_COMPONENTS>* SoA_Field = NULL;
+BCMaskTable2D<FP,NUM_COMPONENTS>*  BCMask    = NULL;
+NodeSpanList2D<FP,NUM_COMPONENTS>* NodeSpans = NULL;
 FP             Ts0,A,W,Mach;
 
 UArray< XY<int> >* GlobalSubDomain;
 UArray< XY<int> >* WallNodes;
+#ifdef _MPI
+int                ProcGridX = 1;           // ranks along X of 2D process grid
+int                ProcGridY = 1;           // ranks along Y of 2D process grid (1 - strips along X)
+UArray< XY<int> >* GlobalSubDomainY = NULL; // rows of process grid (same format as GlobalSubDomain)
+MPI::Cartcomm      ProcGrid2D;              // 2D process grid (rank order of COMM_WORLD)
+#endif // _MPI
 
 UArray<UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >*>*     SubDomainArray;
 UArray<UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >*>* CoreSubDomainArray;
@@ -102,6 +130,7 @@ const  char*  RMS_Name[11] = {"Rho","Rho*U","Rho*V","Rho*E","Rho*Yfu","Rho*Yox",
 int    useSwapFile=0;
 char   RMSFileName[255];
 char   MonitorsFileName[255];
+char   CostFileName[255];          // measured cost of columns (see RebalanceSubDomains())
 char   OldSwapFileName[255];
 void*  OldSwapData;
 u_long OldFileSizeGas;
@@ -121,6 +150,9 @@ char                                         OutFileName[255];
 char                                         TecPlotFileName[255];
 int                                          fd_g;
 void*                                        GasSwapData;
+char                                         ColdSwapFileName[260];
+int                                          fd_c;
+void*                                        ColdSwapData=NULL;
 int                                          TurbMod    = 0;
 int                                          EndFLAG    = 1;
 int                                          PrintFLAG;
@@ -133,6 +165,7 @@ unsigned int                                 last_iter=0;          // Global ite
 int                                          isStop=0;             // Stop flag
 InputData*                                   Data=NULL;            // Object data loader
 UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >*  J=NULL;               // Main computation area
+UMatrix2D< FlowNodeCold2D<FP,NUM_COMPONENTS> >* ColdJ=NULL;        // Cold side-table of main computation area
 UArray<Flow*>*                               FlowList=NULL;        // List of 'Flow' objects
 UArray<Flow2D*>*                             Flow2DList=NULL;      // List of 'Flow2D' objects
 UArray<Bound2D*>                             SingleBoundsList;     // Single Bounds List;
@@ -157,6 +190,28 @@ unsigned long                                FileSizeGas           = 0;
 int                                          isVerboseOutput       = 0;
 int                                          isTurbulenceReset     = 0;
 
+// 1 if all Flow, Flow2D objects and gas sources of case are air (CompIndex=3),
+// so species equations are not needed (S[i2d_Yfu...i2d_Ycp] = 0 in all nodes)
+static int isSingleGasData(InputData* _data) {
+    char Str[256];
+    int  NumObj;
+
+    const char* NumKey[3]  = {"NumFlow","NumFlow2D","NumSrc"};
+    const char* CompKey[3] = {"Flow%i.CompIndex","Flow2D-%i.CompIndex","Src%i.GasSrcIndex"};
+
+    for (int l=0;l<3;l++ ) {
+        if(!_data->CheckData((char*)NumKey[l]))
+           continue;
+        NumObj = _data->GetIntVal((char*)NumKey[l]);
+        for (int i=0;i<NumObj;i++ ) {
+             snprintf(Str,256,CompKey[l],i+1);
+             if(!_data->CheckData(Str) || _data->GetIntVal(Str) != 3)
+                return 0;
+        }
+    }
+    return 1;
+}
+
 void InitSharedData(InputData* _data,
                     void* CRM_data
 #ifdef _MPI
@@ -285,6 +340,190 @@ void InitSharedData(InputData* _data,
                 Abort_OpenHyperFLOW2D();
             }
 
+            if(_data->CheckData((char*)"FieldStorage")) {            // Flow field storage type (optional)
+               FieldStorage = _data->GetIntVal((char*)"FieldStorage");
+               if ( _data->GetDataError()==-1 ) {
+                   Abort_OpenHyperFLOW2D();
+               }
+               if(FieldStorage > FST_SOA) {
+#ifdef _MPI
+                  if(rank == 0)
+#endif // _MPI
+                  *(_data->GetMessageStream()) << "WARNING: FieldStorage=" << FieldStorage << " isn't supported, FieldStorage=1 is used.\n" << flush;
+                  FieldStorage = FST_SOA;
+               }
+            } else {
+#ifdef _SOA_FIELD_STORAGE_
+               FieldStorage = FST_SOA;
+#else
+               FieldStorage = FST_AOS;
+#endif // _SOA_FIELD_STORAGE_
+            }
+
+            isFusedSweep = 0;
+            if(_data->CheckData((char*)"isFusedSweep")) {            // 1 - single pass Stage 1+2 sweep (optional)
+               isFusedSweep = _data->GetIntVal((char*)"isFusedSweep");
+               if ( _data->GetDataError()==-1 ) {
+                   Abort_OpenHyperFLOW2D();
+               }
+            }
+
+            isBatchFill = 0;
+            if(_data->CheckData((char*)"isBatchFill")) {             // 1 - batched FillNode2D() for plain gas nodes (optional)
+               isBatchFill = _data->GetIntVal((char*)"isBatchFill");
+               if ( _data->GetDataError()==-1 ) {
+                   Abort_OpenHyperFLOW2D();
+               }
+            }
+
+            isGlobalTimeStep = 0;
+            if(_data->CheckData((char*)"isGlobalTimeStep")) {        // 1 - all subdomains use dt of previous iterations (optional)
+               isGlobalTimeStep = _data->GetIntVal((char*)"isGlobalTimeStep");
+               if ( _data->GetDataError()==-1 ) {
+                   Abort_OpenHyperFLOW2D();
+               }
+            }
+
+            if(_data->CheckData((char*)"NumSpeciesEq")) {            // 0 - single gas, NUM_COMPONENTS - all species equations (optional)
+               NumSpeciesEq = _data->GetIntVal((char*)"NumSpeciesEq");
+               if ( _data->GetDataError()==-1 ||
+                    (NumSpeciesEq != 0 && NumSpeciesEq != NUM_COMPONENTS)) {
+                   Abort_OpenHyperFLOW2D();
+               }
+            } else {
+               NumSpeciesEq = isSingleGasData(_data) ? 0 : NUM_COMPONENTS;
+            }
+
+            TemporalBlock = 1;
+            if(_data->CheckData((char*)"TemporalBlock")) {           // Iterations per temporal block (optional)
+               TemporalBlock = max(1,_data->GetIntVal((char*)"TemporalBlock"));
+               if ( _data->GetDataError()==-1 ) {
+                   Abort_OpenHyperFLOW2D();
+               }
+            }
+#ifdef _MPI
+            // Temporal blocks of ranks are set by halo depth (see DEEPS2D_Run())
+            TemporalBlock = 1;
+#endif // _MPI
+
+#if defined(_OPENMP) && defined(_MPI)
+            TileX = TileY = 32;                                      // threads of hybrid rank sweep tiles
+#else
+            TileX = TileY = 0;
+#endif // _OPENMP
+            if(_data->CheckData((char*)"TileX")) {                   // Tile width of task-based sweep, 0 - off (optional)
+               TileX = _data->GetIntVal((char*)"TileX");
+               if ( _data->GetDataError()==-1 || TileX < 0 ) {
+                   Abort_OpenHyperFLOW2D();
+               }
+            }
+            if(_data->CheckData((char*)"TileY")) {                   // Tile height of task-based sweep, 0 - whole column (optional)
+               TileY = _data->GetIntVal((char*)"TileY");
+               if ( _data->GetDataError()==-1 || TileY < 0 ) {
+                   Abort_OpenHyperFLOW2D();
+               }
+            }
+#if defined(_MPI) && !defined(_OPENMP)
+            // single thread ranks sweep whole local field
+            if(TileX > 0 && rank == 0)
+               *(_data->GetMessageStream()) << "WARNING: TileX is ignored, ranks of MPI version aren't threaded.\n" << flush;
+            TileX = 0;
+#endif // _MPI
+
+            isThreadPinning = 0;
+            if(_data->CheckData((char*)"isThreadPinning")) {         // 1 - pin OpenMP threads to CPUs (optional)
+               isThreadPinning = _data->GetIntVal((char*)"isThreadPinning");
+               if ( _data->GetDataError()==-1 ) {
+                   Abort_OpenHyperFLOW2D();
+               }
+            }
+
+            isNUMAPlacement = 0;
+            if(_data->CheckData((char*)"isNUMAPlacement")) {         // 1 - place subdomains on NUMA nodes of threads (optional)
+               isNUMAPlacement = _data->GetIntVal((char*)"isNUMAPlacement");
+               if ( _data->GetDataError()==-1 ) {
+                   Abort_OpenHyperFLOW2D();
+               }
+            }
+
+            AsyncOutput = 0;
+            if(_data->CheckData((char*)"AsyncOutput")) {             // Snapshot buffers of writer thread, 0 - synchronous output (optional)
+               AsyncOutput = _data->GetIntVal((char*)"AsyncOutput");
+               if ( _data->GetDataError()==-1 || AsyncOutput < 0 ) {
+                   Abort_OpenHyperFLOW2D();
+               }
+            }
+
+            RebalanceStep = 0;
+#ifdef _MPI
+            // ranks don't redistribute subdomains at runtime, measured cost is used by next start only
+            if(_data->CheckData((char*)"RebalanceStep") && rank == 0)
+               *(_data->GetMessageStream()) << "WARNING: RebalanceStep is ignored by MPI version, use CostStep.\n" << flush;
+            if(_data->CheckData((char*)"CostStep")) {                // Outer cycles between saving of measured cost of columns for next start, 0 - off (optional)
+               RebalanceStep = _data->GetIntVal((char*)"CostStep");
+               if ( _data->GetDataError()==-1 || RebalanceStep < 0 ) {
+                   Abort_OpenHyperFLOW2D();
+               }
+            }
+#else
+            if(_data->CheckData((char*)"RebalanceStep")) {           // Outer cycles between rebalancing of subdomains by measured time, 0 - off (optional)
+               RebalanceStep = _data->GetIntVal((char*)"RebalanceStep");
+               if ( _data->GetDataError()==-1 || RebalanceStep < 0 ) {
+                   Abort_OpenHyperFLOW2D();
+               }
+            }
+#endif // _MPI
+#if defined(_OPENMP) && !defined(_MPI)
+            // tiles of task-based sweep aren't mapped to subdomains
+            if(TileX > 0 && TemporalBlock == 1 && isNUMAPlacement) {
+               *(_data->GetMessageStream()) << "WARNING: isNUMAPlacement is ignored with tiled sweep (TileX > 0).\n" << flush;
+               isNUMAPlacement = 0;
+            }
+#endif // _OPENMP
+
+#ifdef _MPI
+            ProcGridY = 1;
+            if(_data->CheckData((char*)"ProcGridY")) {               // Ranks along Y of process grid, 0 - auto (optional)
+               ProcGridY = _data->GetIntVal((char*)"ProcGridY");
+               if ( _data->GetDataError()==-1 || ProcGridY < 0 ) {
+                   Abort_OpenHyperFLOW2D();
+               }
+            }
+            InitProcGrid2D(_data,rank);
+
+            isPackedHalo = 1;
+            if(_data->CheckData((char*)"isPackedHalo")) {            // 0 - halo exchange sends whole nodes (optional)
+               isPackedHalo = _data->GetIntVal((char*)"isPackedHalo");
+               if ( _data->GetDataError()==-1 ) {
+                   Abort_OpenHyperFLOW2D();
+               }
+            }
+
+            isHaloOverlap = 1;
+            if(_data->CheckData((char*)"isHaloOverlap")) {           // 0 - halo exchange after sweep of whole local field (optional)
+               isHaloOverlap = _data->GetIntVal((char*)"isHaloOverlap");
+               if ( _data->GetDataError()==-1 ) {
+                   Abort_OpenHyperFLOW2D();
+               }
+            }
+
+            HaloDepth = 1;
+            if(_data->CheckData((char*)"HaloDepth")) {               // Halo columns/rows exchanged every HaloDepth iterations (optional)
+               HaloDepth = _data->GetIntVal((char*)"HaloDepth");
+               if ( _data->GetDataError()==-1 || HaloDepth < 1 ) {
+                   Abort_OpenHyperFLOW2D();
+               }
+            }
+#endif // _MPI
+
+            SIMDKernel = GetSIMDLevel();
+            if(_data->CheckData((char*)"SIMDKernel")) {              // Max SIMD level of interior node kernel (optional)
+               SIMDKernel = min(SIMDKernel,_data->GetIntVal((char*)"SIMDKernel"));
+               if ( _data->GetDataError()==-1 ) {
+                   Abort_OpenHyperFLOW2D();
+               }
+            }
+
             MonitorIndex = _data->GetIntVal((char*)"MonitorIndex");
             if ( _data->GetDataError()==-1 ) {
                 Abort_OpenHyperFLOW2D();
@@ -496,114 +735,783 @@ void InitSharedData(InputData* _data,
             FlowNode2D<FP,NUM_COMPONENTS>::Hu[h_ox]  = model_data->H_OX;
             FlowNode2D<FP,NUM_COMPONENTS>::Hu[h_cp]  = model_data->H_cp;
             FlowNode2D<FP,NUM_COMPONENTS>::Hu[h_air] = model_data->H_air;
+
+            SetMixtureTables2D(model_data);
 };
 
+void ComputationalUnstability2D(ofstream* f_stream,
+                                FlowNode2D<FP,NUM_COMPONENTS>* CurrentNode,
+                                int i, int j, FP dt
 #ifdef _MPI
-struct Var_pack {
-       FP   dt_min;
-#ifdef __INTEL_COMPILER
-       DD_pack  DD[4+NUM_COMPONENTS+2];
-#else 
-       DD_pack  DD[FlowNode2D<FP,NUM_COMPONENTS>::NumEq];
-#endif //__INTEL_COMPILER
+                                ,int rank, FP x0, FP y0
+#endif // _MPI
+                                ) {
+    *f_stream << "\nTg=" << CurrentNode->Tg << " K. p=" << CurrentNode->p <<" Pa dt=" << dt << " sec.\n" << flush;
+#ifdef _MPI
+    *f_stream << "\nERROR: Computational unstability in UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >(" << (int)(x0/FlowNode2D<FP,NUM_COMPONENTS>::dx) + i <<","<< (int)(y0/FlowNode2D<FP,NUM_COMPONENTS>::dy) + j << ") \nNode Conditions {\n";
+     PrintCond(f_stream,CurrentNode);
+    *f_stream  <<"} on iteration " << iter+last_iter<< "...\n";
+#else
+  #ifdef _OPENMP
+    *f_stream << "\nERROR: Computational unstability in local (num_thread="<< omp_get_thread_num() << ") UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >(" << i <<","<< j <<") \nNode Conditions {\n";
+    PrintCond(f_stream,CurrentNode);
+    *f_stream  <<"} on iteration " << iter+last_iter<< "...\n";
+  #else
+    *f_stream << "\nERROR: Computational unstability in UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >(" << i <<","<< j <<") \nNode Conditions {\n";
+    PrintCond(f_stream,CurrentNode);
+    *f_stream  <<"} on iteration " << iter+last_iter<< "...\n";
+  #endif // _OPENMP
+#endif // _MPI
+
+    WaitSnapshotWriter2D();                  // queued snapshots are saved before exit
+
+#ifdef _OPENMP
+#pragma omp critical
+      {
+        char omp_ErrFileName[255];
+        snprintf(omp_ErrFileName,255,"tid-%d-%s",omp_get_thread_num(),ErrFileName);  
+        DataSnapshot(omp_ErrFileName);
+#endif // _OPENMP
+#ifdef _MPI
+      if( rank == 0 ) {
+        char mpi_ErrFileName[255];
+        snprintf(mpi_ErrFileName,255,"rank-%d-%s",rank,ErrFileName);  
+        DataSnapshot(mpi_ErrFileName);
+#else  //  _MPI
+
+        DataSnapshot(ErrFileName);
+#endif // _MPI
+#ifdef _OPENMP
+       *f_stream << "Computation terminated. Error data saved in file "<< omp_ErrFileName <<" \n" ;
+#else
+#endif //  _OPENMP
+
+#ifdef _MPI
+#ifdef _OPENMP
+        if(rank == 0)
+          *f_stream << "Computation terminated. Error data saved in file "<< mpi_ErrFileName <<" \n";
+#else  //  _MPI
+
+        *f_stream << "Computation terminated. Error data saved in file "<< ErrFileName <<" \n" ;
+#endif //  _OPENMP
+#endif // _MPI
+
+         f_stream->flush();
+
+        if ( GasSwapData!=0 ) {
+#ifdef _REMOVE_SWAPFILE_
+            CloseSwapFile(GasSwapFileName,
+                          GasSwapData,
+                          FileSizeGas,
+                          fd_g,
+                          1);
+#endif // _REMOVE_SWAPFILE_
+
+            useSwapFile = 0; 
+        }
+#ifdef _OPENMP
+     }
+#endif // _OPENMP
+#ifdef _MPI
+     }
+#endif // _MPI
+
+  isRun = 0;
+  Abort_OpenHyperFLOW2D();
+}
+
+inline int isOutStep(unsigned int it, int n_it) {
+    // NOutStep multiple in [it, it+n_it)
+    return (it+n_it-1)/NOutStep*NOutStep >= it;
+}
+
+// First column of subdomain view pJ in field (MPI - local field of rank)
+inline long SubDomainOffset2D(UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* pJ) {
+#ifdef _MPI
+    return 0;
+#else
+    return (long)(pJ->GetMatrixPtr()-J->GetMatrixPtr())/MaxY;
+#endif // _MPI
+}
+
+// Stage (1 or 2) for global columns i_start...i_end-1 of subdomain pJ (core matrix pC)
+// (sp - copy of sweep parameters, rows sp->StartYLocal...sp->MaxYLocal-1)
+static void DEEPS2D_SubDomainStage(int stage,
+                                   UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >*     pJ,
+                                   UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >* pC,
+                                   int i_start, int i_end,
+                                   SweepParam2D* p_sp,
+                                   DEEPS2D_Kernel2D< FlowFieldSoA2D<FP,NUM_COMPONENTS> >* SoA_Kernel,
+                                   DEEPS2D_Kernel2D< FlowFieldAoS2D<FP,NUM_COMPONENTS> >* AoS_Kernel,
+                                   ofstream* f_stream) {
+    SweepParam2D& sp = *p_sp;
+
+    sp.x_offset    = SubDomainOffset2D(pJ);
+    sp.col_offset  = sp.x_offset;
+    sp.StartXLocal = i_start - (int)sp.x_offset;
+    sp.MaxXLocal   = i_end - (int)sp.x_offset;
+
+    if(FieldStorage == FST_SOA) {
+       sp.bc   = BCMask->GetMask();
+       sp.cold = ColdJ->GetMatrixPtr();
+       if(stage == 1)
+          SoA_Kernel->Stage1(*SoA_Field,&sp);
+       else
+          SoA_Kernel->Stage2(*SoA_Field,&sp,f_stream);
+    } else {
+       FlowFieldAoS2D<FP,NUM_COMPONENTS> AoS_Field(pJ,pC);
+       sp.bc       = BCMask->GetMask(sp.x_offset*MaxY);
+       sp.cold     = ColdJ->GetMatrixPtr()+sp.x_offset*MaxY;
+       sp.x_offset = 0;
+       if(stage == 1)
+          AoS_Kernel->Stage1(AoS_Field,&sp);
+       else
+          AoS_Kernel->Stage2(AoS_Field,&sp,f_stream);
+    }
+}
+
+#ifndef _MPI
+// Stage (1 or 2) of level l for global column g (subdomain owner[g])
+static void DEEPS2D_TemporalBlockColumn(int stage, int l, int g, int* owner,
+                                        SweepParam2D* sp_block,
+                                        DEEPS2D_Kernel2D< FlowFieldSoA2D<FP,NUM_COMPONENTS> >* SoA_Kernel,
+                                        DEEPS2D_Kernel2D< FlowFieldAoS2D<FP,NUM_COMPONENTS> >* AoS_Kernel,
+                                        ofstream* f_stream) {
+    SweepParam2D sp = *sp_block;
+
+    sp.res  += l*(int)J->GetX();
+    sp.iter += l;
+
+    DEEPS2D_SubDomainStage(stage,SubDomainArray->GetElement(owner[g]),CoreSubDomainArray->GetElement(owner[g]),
+                           g,g+1,&sp,SoA_Kernel,AoS_Kernel,f_stream);
+}
+
+// Temporal blocking: n_block iterations with frozen dt in one pass over field.
+// Level l (iteration iter+l) makes fused step (Stage 1 of column g, Stage 2 of
+// column g-1) at wavefront step g+lag*l, so only ~lag*n_block columns are live.
+// Level l+1 reads columns of level l after its Stage 2 is finished, lag=3
+// keeps levels at the same wavefront step independent (run in parallel).
+// Residuals and dt_min of level l are accumulated in columns l*MaxX...l*MaxX+MaxX-1 of sp_block->res.
+static void DEEPS2D_TemporalBlock(int n_block, SweepParam2D* sp_block,
+                                  DEEPS2D_Kernel2D< FlowFieldSoA2D<FP,NUM_COMPONENTS> >* SoA_Kernel,
+                                  DEEPS2D_Kernel2D< FlowFieldAoS2D<FP,NUM_COMPONENTS> >* AoS_Kernel,
+                                  ofstream* f_stream) {
+    const int lag = 3;
+    const int n_s = (int)SubDomainArray->GetNumElements();
+    const int n_x = (int)J->GetX();
+    int*      owner = new int[n_x];
+
+    for(int ii=0;ii<n_s;ii++) {
+        UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* pJ = SubDomainArray->GetElement(ii);
+        const int x_offset = (int)((pJ->GetMatrixPtr()-J->GetMatrixPtr())/MaxY);
+        const int i_start  = (ii == 0)     ? 0 : 1;
+        const int i_end    = (ii == n_s-1) ? (int)pJ->GetX() : (int)pJ->GetX()-1;
+        for(int i=i_start;i<i_end;i++)
+            owner[x_offset+i] = ii;
+    }
+
+    for(int step=0;step<=n_x+lag*(n_block-1);step++) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static,1)
+#endif //_OPENMP
+        for(int l=0;l<n_block;l++) {
+            const int g = step-lag*l;
+            if(g >= 0 && g < n_x)
+               DEEPS2D_TemporalBlockColumn(1,l,g,owner,sp_block,SoA_Kernel,AoS_Kernel,f_stream);
+            if(g > 0 && g <= n_x)
+               DEEPS2D_TemporalBlockColumn(2,l,g-1,owner,sp_block,SoA_Kernel,AoS_Kernel,f_stream);
+        }
+    }
+
+    delete[] owner;
+}
+
+#endif // _MPI
+
+// Tile of task-based sweep: global columns i_start...i_end-1 of subdomain pJ (core matrix pC),
+// rows j_start...j_end-1, ty - row of tiles
+struct SweepTile2D {
+       UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >*     pJ;
+       UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >* pC;
+       int i_start, i_end;
+       int j_start, j_end;
+       int ty;
+#ifdef _MPI
+       Var_pack* DD_max;          // residuals of tile (see DEEPS2D_TileResiduals())
+#endif // _MPI
 };
+
+// Split subdomains sd (core matrices core_sd) to tiles of nx*ny nodes (ny=0 - whole column)
+// in column major order, tiles don't cross subdomain bounds, all columns of tiles have the same rows.
+// First l_overlap (last r_overlap) columns of first (last) subdomain aren't covered (halo,
+// MPI - also edge columns), tiles cover rows j_start...j_end-1.
+// Returns number of tiles, *n_ty - number of rows of tiles.
+static int DEEPS2D_SetTiles(SweepTile2D* volatile* tiles, volatile int* n_ty, int nx, int ny,
+                            UArray<UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >*>*     sd,
+                            UArray<UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >*>* core_sd,
+                            int l_overlap, int r_overlap, int j_start, int j_end) {
+    const int n_s = (int)sd->GetNumElements();
+    int       n_tx = 0, t = 0;
+
+    if(ny == 0 || ny > j_end-j_start)
+       ny = j_end-j_start;
+
+    *n_ty = (j_end-j_start+ny-1)/ny;
+
+    for(int ii=0;ii<n_s;ii++) {
+        UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* pJ = sd->GetElement(ii);
+        const int i_start  = (ii == 0)     ? l_overlap : 1;
+        const int i_end    = (ii == n_s-1) ? (int)pJ->GetX()-r_overlap : (int)pJ->GetX()-1;
+        n_tx += (i_end-i_start+nx-1)/nx;
+    }
+
+    *tiles = new SweepTile2D[n_tx*(*n_ty)];
+
+    for(int ii=0;ii<n_s;ii++) {
+        UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* pJ = sd->GetElement(ii);
+        const int x_offset = (int)SubDomainOffset2D(pJ);
+        const int i_start  = (ii == 0)     ? l_overlap : 1;
+        const int i_end    = (ii == n_s-1) ? (int)pJ->GetX()-r_overlap : (int)pJ->GetX()-1;
+        for(int i=i_start;i<i_end;i+=nx)
+            for(int ty=0;ty<*n_ty;ty++,t++) {
+                (*tiles)[t].pJ      = pJ;
+                (*tiles)[t].pC      = core_sd->GetElement(ii);
+                (*tiles)[t].i_start = x_offset+i;
+                (*tiles)[t].i_end   = x_offset+min(i+nx,i_end);
+                (*tiles)[t].j_start = j_start+ty*ny;
+                (*tiles)[t].j_end   = min(j_start+(ty+1)*ny,j_end);
+                (*tiles)[t].ty      = ty;
+            }
+    }
+    return t;
+}
+
+// Stage (1 or 2) of tile t, residuals of row of tiles t->ty
+// are accumulated in columns ty*MaxX...ty*MaxX+MaxX-1 of sp_tiles->res
+// (MPI - in residuals of tile t->DD_max).
+static void DEEPS2D_TileStage(int stage, SweepTile2D* t, SweepParam2D* sp_tiles,
+                              DEEPS2D_Kernel2D< FlowFieldSoA2D<FP,NUM_COMPONENTS> >* SoA_Kernel,
+                              DEEPS2D_Kernel2D< FlowFieldAoS2D<FP,NUM_COMPONENTS> >* AoS_Kernel,
+                              ofstream* f_stream) {
+    SweepParam2D sp = *sp_tiles;
+
+    sp.StartYLocal = t->j_start;
+    sp.MaxYLocal   = t->j_end;
+#ifdef _MPI
+    sp.DD_max      = t->DD_max;
+#else
+    sp.res        += t->ty*(int)J->GetX();
+#endif // _MPI
+
+    DEEPS2D_SubDomainStage(stage,t->pJ,t->pC,t->i_start,t->i_end,&sp,SoA_Kernel,AoS_Kernel,f_stream);
+}
+
+// Task-based tiled sweep (tiles from DEEPS2D_SetTiles()).
+// Stage 1 of tile waits for Stage 1 of left and lower tiles, Stage 2 - for
+// Stage 1 of tile and its 4 neighbors and Stage 2 of left and lower tiles.
+// So every node sees the same neighbor values as in column by column
+// sweep of whole field (result doesn't depend on number of threads),
+// ready tiles (about one diagonal of tiles) are run by free threads.
+// stages - 1 (Stage 1 only), 2 (Stage 2 only) or 3 (both stages).
+static void DEEPS2D_TiledSweep(int stages, SweepTile2D* tiles, int n_tiles, int n_ty, SweepParam2D* sp_tiles,
+                               DEEPS2D_Kernel2D< FlowFieldSoA2D<FP,NUM_COMPONENTS> >* SoA_Kernel,
+                               DEEPS2D_Kernel2D< FlowFieldAoS2D<FP,NUM_COMPONENTS> >* AoS_Kernel,
+                               ofstream* f_stream) {
+    char* s1 = new char[n_tiles+1];  // task dependence objects of Stage 1 and Stage 2,
+    char* s2 = new char[n_tiles+1];  // [n_tiles] - missing neighbor
+
+#ifdef _OPENMP
+#pragma omp parallel
+#pragma omp single
+#endif //_OPENMP
+    {
+     for(int t=0;t<n_tiles && (stages & 1);t++) {
+#ifdef _OPENMP
+         const int l = (t >= n_ty)      ? t-n_ty : n_tiles;
+         const int d = (t % n_ty > 0)   ? t-1    : n_tiles;
+#pragma omp task depend(in: s1[l], s1[d]) depend(out: s1[t])
+#endif //_OPENMP
+         DEEPS2D_TileStage(1,tiles+t,sp_tiles,SoA_Kernel,AoS_Kernel,f_stream);
+     }
+
+     for(int t=0;t<n_tiles && (stages & 2);t++) {
+#ifdef _OPENMP
+         const int l = (t >= n_ty)              ? t-n_ty : n_tiles;
+         const int r = (t+n_ty < n_tiles)       ? t+n_ty : n_tiles;
+         const int d = (t % n_ty > 0)           ? t-1    : n_tiles;
+         const int u = (t % n_ty < n_ty-1)      ? t+1    : n_tiles;
+#pragma omp task depend(in: s1[t], s1[l], s1[r], s1[d], s1[u], s2[l], s2[d]) depend(out: s2[t])
+#endif //_OPENMP
+         DEEPS2D_TileStage(2,tiles+t,sp_tiles,SoA_Kernel,AoS_Kernel,f_stream);
+     }
+    }
+
+    delete[] s1;
+    delete[] s2;
+}
+
+#ifdef _MPI
+// Clean residuals and dt_min of tile (or rank)
+inline void ClearVarPack2D(Var_pack* v) {
+    v->dt_min = 1.;
+    for (int k=0;k<(int)FlowNode2D<FP,NUM_COMPONENTS>::NumEq;k++ ) {
+         v->DD[k].DD     = v->DD[k].RMS = v->DD[k].sumDiv = 0.;
+         v->DD[k].iRMS   = 0;
+         v->DD[k].i      = v->DD[k].j = 0;
+    }
+}
+
+// Add residuals v to residuals dd: sums of RMS and nodes, max residual with location, min dt
+inline void AddVarPack2D(Var_pack* dd, const Var_pack* v) {
+    dd->dt_min = min(dd->dt_min,v->dt_min);
+    for (int k=0;k<(int)FlowNode2D<FP,NUM_COMPONENTS>::NumEq;k++ ) {
+         dd->DD[k].RMS    += v->DD[k].RMS;
+         dd->DD[k].sumDiv += v->DD[k].sumDiv;
+         dd->DD[k].iRMS   += v->DD[k].iRMS;
+         if(v->DD[k].DD > dd->DD[k].DD) {
+            dd->DD[k].DD = v->DD[k].DD;
+            dd->DD[k].i  = v->DD[k].i;
+            dd->DD[k].j  = v->DD[k].j;
+         }
+    }
+}
+
+// Add residuals of tiles to residuals of rank dd (in tile order) and clean them for next sweep
+static void DEEPS2D_TileResiduals(Var_pack* dd, SweepTile2D* tiles, int n_tiles) {
+    for(int t=0;t<n_tiles;t++) {
+        AddVarPack2D(dd,tiles[t].DD_max);
+        ClearVarPack2D(tiles[t].DD_max);
+    }
+}
+
+// Values (p, T) of monitor points stored after residuals of rank v (see DEEPS2D_Run())
+inline FP* MonitorValues2D(Var_pack* v) {
+    return (FP*)(v+1);
+}
+
+// User op of reduction of ranks: residuals are added by AddVarPack2D(), values of
+// monitor points are summed (only rank of monitor point stores nonzero values)
+static void ReduceVarPack2D(const void* in, void* inout, int len, const MPI::Datatype& type) {
+    const int size = type.Get_size();
+    const int n_fp = (size-(int)sizeof(Var_pack))/(int)sizeof(FP);
+
+    for(int n=0;n<len;n++) {
+        const Var_pack* a = (const Var_pack*)((const char*)in+n*size);
+        Var_pack*       b = (Var_pack*)((char*)inout+n*size);
+
+        AddVarPack2D(b,a);
+        for(int m=0;m<n_fp;m++)
+            MonitorValues2D(b)[m] += ((const FP*)(a+1))[m];
+    }
+}
+#endif // _MPI
+
+// Write swap file fd (gas area or its cold side-table) from ptr (size bytes), returns number of written bytes
+static ssize_t WriteSwapFile2D(int fd, char* ptr, ssize_t size, ofstream* f_stream) {
+#ifdef _WRITE_LARGE_FILE_
+    ssize_t max_write = 1024L*1024L*1024L;
+    ssize_t one_write = 0L;
+    ssize_t len  = 0L;
+    off_t  off = 0L;
+    lseek(fd,0,SEEK_SET);
+    if(size > max_write) {
+       for(off = 0L,one_write = max_write; len < size; off += max_write) {
+       len += pwrite64(fd,ptr+off,one_write,off);
+       if(size - len < max_write)
+          one_write = size - len;
+        }
+    if(len != size)
+       *f_stream << "Error: len(" << len << ") != FileSize(" << size << ") " << endl << flush;
+    } else {
+       len = pwrite64(fd,ptr,size,0L);
+    }
+    return len;
+#else
+    lseek(fd,0,SEEK_SET);
+    return write(fd,ptr,size);
+#endif // _WRITE_LARGE_FILE_
+}
+
+// Save heat flux of pJ along X or Y (axis) to HeatFlux-<axis>-<OutFileName>
+static void SaveHeatFlux2D(char axis, UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* pJ) {
+    char HeatFluxFileName[sizeof(OutFileName)+16];   // "HeatFlux-X-" + OutFileName
+    snprintf(HeatFluxFileName,sizeof(HeatFluxFileName),"HeatFlux-%c-%s",axis,OutFileName);
+    CutFile(HeatFluxFileName);
+    ofstream* pOut = OpenData(HeatFluxFileName);      // local stream, also called from writer thread
+    if(axis == 'X')
+       SaveXHeatFlux2D(pOut,pJ,Flow2DList->GetElement(Cp_Flow_index-1),Ts0,y_max,y_min);
+    else
+       SaveYHeatFlux2D(pOut,pJ,Ts0);
+    pOut->close();
+    delete pOut;
+}
+
+//////////////////////////////////////////////////
+//  Asynchronous output (snapshot writer thread) //
+//////////////////////////////////////////////////
+// Solver copies J to free snapshot buffer (waits if all buffers are
+// not written yet) and continues, writer thread saves snapshots in order.
+
+static Snapshot2D*     Snapshots   = NULL;   // ring of AsyncOutput buffers
+static unsigned long   SnapPosted  = 0;      // snapshots handed to writer
+static unsigned long   SnapWritten = 0;      // snapshots saved by writer
+static int             isSnapStop  = 0;
+static ofstream*       SnapLog     = NULL;
+static pthread_t       SnapThread;
+static pthread_mutex_t SnapMutex   = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  SnapCond    = PTHREAD_COND_INITIALIZER;
+
+// Save snapshot s (same files and order as synchronous output)
+static void SaveSnapshot2D(Snapshot2D* s) {
+    if(s->out & SNAP_GNUPLOT) {
+       CutFile(OutFileName);
+       ofstream* pOut = OpenData(OutFileName);
+       SaveData2D(pOut,WM_REWRITE,s->pJ,s->time);
+       pOut->close();
+       delete pOut;
+    }
+    if(s->out & SNAP_TECPLOT) {
+       ofstream* pOut = OpenData(TecPlotFileName);
+       SaveData2D(pOut,WM_APPEND,s->pJ,s->time);
+       pOut->close();
+       delete pOut;
+    }
+    if(s->out & SNAP_HEAT_FLUX_X)
+       SaveHeatFlux2D('X',s->pJ);
+    if(s->out & SNAP_HEAT_FLUX_Y)
+       SaveHeatFlux2D('Y',s->pJ);
+    if(s->out & SNAP_SWAP) {
+       WriteSwapFile2D(fd_g,(char*)s->pJ->GetMatrixPtr(),s->pJ->GetMatrixSize(),SnapLog);
+       if(ColdSwapData)
+          WriteSwapFile2D(fd_c,(char*)s->pCold->GetMatrixPtr(),s->pCold->GetMatrixSize(),SnapLog);
+    }
+}
+
+static void* SnapshotWriter2D(void*) {
+    pthread_mutex_lock(&SnapMutex);
+    for(;;) {
+        while(SnapWritten == SnapPosted && !isSnapStop)
+              pthread_cond_wait(&SnapCond,&SnapMutex);
+        if(SnapWritten == SnapPosted)
+           break;
+        Snapshot2D* s = Snapshots + SnapWritten % AsyncOutput;
+        pthread_mutex_unlock(&SnapMutex);
+
+        SaveSnapshot2D(s);
+
+        pthread_mutex_lock(&SnapMutex);
+        SnapWritten++;
+        pthread_cond_broadcast(&SnapCond);
+    }
+    pthread_mutex_unlock(&SnapMutex);
+    return NULL;
+}
+
+// Start writer thread with AsyncOutput snapshot buffers (0 - synchronous output)
+void StartSnapshotWriter2D(ofstream* f_stream) {
+    if(AsyncOutput <= 0 || Snapshots)
+       return;
+
+    Snapshots = new Snapshot2D[AsyncOutput];
+    for(int k=0;k<AsyncOutput;k++) {
+        Snapshots[k].pJ    = new UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >(J->GetX(),J->GetY());
+        Snapshots[k].pCold = new UMatrix2D< FlowNodeCold2D<FP,NUM_COMPONENTS> >(J->GetX(),J->GetY());
+        Snapshots[k].out   = 0;
+    }
+    SnapLog    = f_stream;
+    isSnapStop = 0;
+    if(pthread_create(&SnapThread,NULL,SnapshotWriter2D,NULL) != 0) {
+       *f_stream << "\nWARNING: Can't start snapshot writer, synchronous output is used.\n" << flush;
+       for(int k=0;k<AsyncOutput;k++) {
+           delete Snapshots[k].pJ;
+           delete Snapshots[k].pCold;
+       }
+       delete[] Snapshots;
+       Snapshots   = NULL;
+       AsyncOutput = 0;
+       return;
+    }
+    *f_stream << "Asynchronous output: " << AsyncOutput << " snapshot buffer(s) of "
+              << J->GetMatrixSize()/(1024*1024) << " Mb\n" << flush;
+}
+
+// Free snapshot buffer with copy of J at time t (waits for writer if all buffers are busy),
+// NULL - synchronous output. Cold side-table is copied with SNAP_SWAP (after update of time).
+Snapshot2D* GetSnapshot2D(FP t) {
+    if(Snapshots == NULL)
+       return NULL;
+
+    pthread_mutex_lock(&SnapMutex);
+    while(SnapPosted - SnapWritten >= (unsigned long)AsyncOutput)
+          pthread_cond_wait(&SnapCond,&SnapMutex);
+    Snapshot2D* s = Snapshots + SnapPosted % AsyncOutput;
+    pthread_mutex_unlock(&SnapMutex);
+
+    memcpy((void*)s->pJ->GetMatrixPtr(),(void*)J->GetMatrixPtr(),J->GetMatrixSize());
+    s->time = t;
+    s->out  = 0;
+    return s;
+}
+
+// Hand snapshot s (from GetSnapshot2D()) to writer thread
+void PostSnapshot2D(Snapshot2D* s) {
+    if(s == NULL)
+       return;
+    pthread_mutex_lock(&SnapMutex);
+    SnapPosted++;
+    pthread_cond_broadcast(&SnapCond);
+    pthread_mutex_unlock(&SnapMutex);
+}
+
+// Wait until all posted snapshots are saved
+void WaitSnapshotWriter2D() {
+    if(Snapshots == NULL)
+       return;
+    pthread_mutex_lock(&SnapMutex);
+    while(SnapWritten < SnapPosted)
+          pthread_cond_wait(&SnapCond,&SnapMutex);
+    pthread_mutex_unlock(&SnapMutex);
+}
+
+// Save posted snapshots and stop writer thread
+void StopSnapshotWriter2D() {
+    if(Snapshots == NULL)
+       return;
+    pthread_mutex_lock(&SnapMutex);
+    isSnapStop = 1;
+    pthread_cond_broadcast(&SnapCond);
+    pthread_mutex_unlock(&SnapMutex);
+    pthread_join(SnapThread,NULL);
+
+    for(int k=0;k<AsyncOutput;k++) {
+        delete Snapshots[k].pJ;
+        delete Snapshots[k].pCold;
+    }
+    delete[] Snapshots;
+    Snapshots = NULL;
+}
+
+#ifdef _MPI
+// Add bytes of node field p...p+size-1 to halo datatype blocks
+static void AddHaloBlock2D(int* len, MPI::Aint* disp, int* n_blocks, void* node, void* p, int size) {
+    if(size <= 0)
+       return;
+    len[*n_blocks]  = size;
+    disp[*n_blocks] = MPI::Get_address(p) - MPI::Get_address(node);
+    (*n_blocks)++;
+}
+
+// Datatype of halo node with extent of FlowNode2D (counts and strides are in nodes).
+// is_packed=0 - whole node, else only fields read by sweep of neighbor:
+// S, dSdx, dSdy, A, B of solved equations (S of all species for NS gradients),
+// Tg, U, V for NS gradients and heat flux on wall, dUdy, dVdx, mu for wall
+// friction velocity (rank 0 computes it from J with halo of its subdomain).
+static MPI::Datatype CreateHaloNodeType2D(FlowNode2D<FP,NUM_COMPONENTS>* pn, int is_packed,
+                                          int sm, int turb_eq, int nc, int is_tg, int* node_bytes) {
+    const int     max_blocks = 16;
+    int           len[max_blocks];
+    MPI::Aint     disp[max_blocks];
+    MPI::Datatype types[max_blocks];
+    int           n_blocks = 0;
+    const int     eq_gas   = nc ? 4+NUM_COMPONENTS : 4;                                  // solved equations
+    const int     eq_turb  = turb_eq ? FlowNode2D<FP,NUM_COMPONENTS>::NumEq-(4+NUM_COMPONENTS) : 0;
+    const int     eq_S     = (sm == SM_NS) ? 4+NUM_COMPONENTS : eq_gas;
+    MPI::Datatype Fields, NodeType;
+
+    if(!is_packed) {
+       *node_bytes = sizeof(FlowNode2D<FP,NUM_COMPONENTS>);
+       NodeType = MPI::BYTE.Create_contiguous(sizeof(FlowNode2D<FP,NUM_COMPONENTS>));
+       NodeType.Commit();
+       return NodeType;
+    }
+
+    AddHaloBlock2D(len,disp,&n_blocks,pn,&pn->S[0],eq_S*sizeof(FP));
+    AddHaloBlock2D(len,disp,&n_blocks,pn,&pn->S[4+NUM_COMPONENTS],eq_turb*sizeof(FP));
+    AddHaloBlock2D(len,disp,&n_blocks,pn,&pn->dSdx[0],eq_gas*sizeof(FP));
+    AddHaloBlock2D(len,disp,&n_blocks,pn,&pn->dSdx[4+NUM_COMPONENTS],eq_turb*sizeof(FP));
+    AddHaloBlock2D(len,disp,&n_blocks,pn,&pn->dSdy[0],eq_gas*sizeof(FP));
+    AddHaloBlock2D(len,disp,&n_blocks,pn,&pn->dSdy[4+NUM_COMPONENTS],eq_turb*sizeof(FP));
+    AddHaloBlock2D(len,disp,&n_blocks,pn,&pn->A[0],eq_gas*sizeof(FP));
+    AddHaloBlock2D(len,disp,&n_blocks,pn,&pn->A[4+NUM_COMPONENTS],eq_turb*sizeof(FP));
+    AddHaloBlock2D(len,disp,&n_blocks,pn,&pn->B[0],eq_gas*sizeof(FP));
+    AddHaloBlock2D(len,disp,&n_blocks,pn,&pn->B[4+NUM_COMPONENTS],eq_turb*sizeof(FP));
+    if(sm == SM_NS || is_tg) {
+       AddHaloBlock2D(len,disp,&n_blocks,pn,&pn->Tg,sizeof(FP));
+       AddHaloBlock2D(len,disp,&n_blocks,pn,&pn->U,sizeof(FP));
+       AddHaloBlock2D(len,disp,&n_blocks,pn,&pn->V,sizeof(FP));
+    }
+    if(sm == SM_NS) {
+       AddHaloBlock2D(len,disp,&n_blocks,pn,&pn->dUdy,sizeof(FP));
+       AddHaloBlock2D(len,disp,&n_blocks,pn,&pn->dVdx,sizeof(FP));
+       AddHaloBlock2D(len,disp,&n_blocks,pn,&pn->mu,sizeof(FP));
+    }
+
+    *node_bytes = 0;
+    for(int b=0;b<n_blocks;b++) {
+        types[b]     = MPI::BYTE;
+        *node_bytes += len[b];
+    }
+
+    Fields   = MPI::Datatype::Create_struct(n_blocks,len,disp,types);
+    NodeType = Fields.Create_resized(0,sizeof(FlowNode2D<FP,NUM_COMPONENTS>));
+    Fields.Free();
+    NodeType.Commit();
+    return NodeType;
+}
+
+// Persistent requests of halo exchange of local field pJ (own columns i0...i1-1, rows j0...j1-1)
+// with neighbors of block b: h edge columns/rows are sent, h halo columns/rows are received.
+// Requests of columns are first (*n_x of them). With h > 1 rows span halo columns too,
+// so corners of halo are received from down/up neighbors after exchange of columns
+// (see WaitHaloExchange2D()). Datatypes of columns/rows are created in *col_type/*row_type.
+// Returns number of requests in req[] (max 8).
+static int InitHaloRequests2D(MPI::Prequest* req, int* n_x, UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* pJ,
+                              Block2D* b, int i0, int i1, int j0, int j1, int h,
+                              MPI::Datatype& node_type, MPI::Datatype* col_type, MPI::Datatype* row_type) {
+    const int ri0 = (h > 1 && b->left  != MPI::PROC_NULL) ? i0-h : i0;    // columns of rows
+    const int ri1 = (h > 1 && b->right != MPI::PROC_NULL) ? i1+h : i1;
+    int n = 0;
+
+    if(b->left != MPI::PROC_NULL || b->right != MPI::PROC_NULL) {
+       *col_type = node_type.Create_vector(h,j1-j0,pJ->GetY());
+       col_type->Commit();
+    }
+    if(b->down != MPI::PROC_NULL || b->up != MPI::PROC_NULL) {
+       *row_type = node_type.Create_vector(ri1-ri0,h,pJ->GetY());
+       row_type->Commit();
+    }
+
+    if(b->right != MPI::PROC_NULL) {
+       req[n++] = MPI::COMM_WORLD.Send_init(&pJ->GetValue(i1-h,j0),1,*col_type,b->right,tag_MatrixTail);
+       req[n++] = MPI::COMM_WORLD.Recv_init(&pJ->GetValue(i1,j0),1,*col_type,b->right,tag_MatrixHead);
+    }
+    if(b->left != MPI::PROC_NULL) {
+       req[n++] = MPI::COMM_WORLD.Recv_init(&pJ->GetValue(i0-h,j0),1,*col_type,b->left,tag_MatrixTail);
+       req[n++] = MPI::COMM_WORLD.Send_init(&pJ->GetValue(i0,j0),1,*col_type,b->left,tag_MatrixHead);
+    }
+    *n_x = n;
+    if(b->up != MPI::PROC_NULL) {
+       req[n++] = MPI::COMM_WORLD.Send_init(&pJ->GetValue(ri0,j1-h),1,*row_type,b->up,tag_MatrixUp);
+       req[n++] = MPI::COMM_WORLD.Recv_init(&pJ->GetValue(ri0,j1),1,*row_type,b->up,tag_MatrixDown);
+    }
+    if(b->down != MPI::PROC_NULL) {
+       req[n++] = MPI::COMM_WORLD.Recv_init(&pJ->GetValue(ri0,j0-h),1,*row_type,b->down,tag_MatrixUp);
+       req[n++] = MPI::COMM_WORLD.Send_init(&pJ->GetValue(ri0,j0),1,*row_type,b->down,tag_MatrixDown);
+    }
+    return n;
+}
+
+// Wait for first n_started requests of halo exchange, then start and wait
+// for the rest of n_halo requests (rows with corners of halo, see InitHaloRequests2D())
+static void WaitHaloExchange2D(MPI::Prequest* req, int n_started, int n_halo) {
+    for(int ii=0;ii<n_started;ii++)
+        req[ii].Wait();
+
+    if(n_started < n_halo) {
+       MPI::Prequest::Startall(n_halo-n_started,req+n_started);
+       for(int ii=n_started;ii<n_halo;ii++)
+           req[ii].Wait();
+    }
+}
+
+// Stage 2 of edge nodes of local field pJ (own columns/rows next to halo of neighbors,
+// l, r, d, u - width of edge at left, right, down, up side, 0 - no neighbor), so halo
+// exchange can be started before Stage 2 of interior nodes. Stage 1 of all own nodes
+// must be done, sp - sweep parameters of all own nodes.
+static void DEEPS2D_EdgeStage2(UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >*     pJ,
+                               UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >* pC,
+                               int l, int r, int d, int u, SweepParam2D* sp,
+                               DEEPS2D_Kernel2D< FlowFieldSoA2D<FP,NUM_COMPONENTS> >* SoA_Kernel,
+                               DEEPS2D_Kernel2D< FlowFieldAoS2D<FP,NUM_COMPONENTS> >* AoS_Kernel,
+                               ofstream* f_stream) {
+    SweepParam2D e   = *sp;
+    const int    i0  = min(sp->StartXLocal+l,sp->MaxXLocal);   // columns of down/up edge rows
+    const int    i1  = max(i0,sp->MaxXLocal-r);
+    const int    j0  = min(sp->StartYLocal+d,sp->MaxYLocal);
+    const int    j1  = max(j0,sp->MaxYLocal-u);
+
+    if(l)
+       DEEPS2D_SubDomainStage(2,pJ,pC,sp->StartXLocal,i0,&e,SoA_Kernel,AoS_Kernel,f_stream);
+
+    if(d) {
+       e.StartYLocal = sp->StartYLocal;
+       e.MaxYLocal   = j0;
+       DEEPS2D_SubDomainStage(2,pJ,pC,i0,i1,&e,SoA_Kernel,AoS_Kernel,f_stream);
+    }
+
+    if(u && j1 < sp->MaxYLocal) {
+       e.StartYLocal = j1;
+       e.MaxYLocal   = sp->MaxYLocal;
+       DEEPS2D_SubDomainStage(2,pJ,pC,i0,i1,&e,SoA_Kernel,AoS_Kernel,f_stream);
+    }
+
+    if(r && i1 < sp->MaxXLocal) {
+       e.StartYLocal = sp->StartYLocal;
+       e.MaxYLocal   = sp->MaxYLocal;
+       DEEPS2D_SubDomainStage(2,pJ,pC,i1,sp->MaxXLocal,&e,SoA_Kernel,AoS_Kernel,f_stream);
+    }
+}
 #endif // _MPI
 
 void DEEPS2D_Run(ofstream* f_stream
 #ifdef _MPI
                 ,UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >*     pJ,
                  UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >* pC,
-                 int rank, int last_rank, FP x0
+                 int rank, int last_rank, FP x0, FP y0
 #endif //_MPI
                  ) {
 
    // local variables
 #ifdef __ICC
-    __declspec(align(_ALIGN)) FlowNode2D< FP,NUM_COMPONENTS >* CurrentNode=NULL;
-    __declspec(align(_ALIGN)) FlowNodeCore2D< FP,NUM_COMPONENTS >* NextNode=NULL;
-    __declspec(align(_ALIGN)) FlowNode2D< FP,NUM_COMPONENTS >* UpNode=NULL;          // neast
-    __declspec(align(_ALIGN)) FlowNode2D< FP,NUM_COMPONENTS >* DownNode=NULL;        // nodes
-    __declspec(align(_ALIGN)) FlowNode2D< FP,NUM_COMPONENTS >* LeftNode=NULL;        // references
-    __declspec(align(_ALIGN)) FlowNode2D< FP,NUM_COMPONENTS >* RightNode=NULL;
-    __declspec(align(_ALIGN)) FP   beta; 
-    __declspec(align(_ALIGN)) FP   _beta;
-    __declspec(align(_ALIGN)) FP   dXX;
-    __declspec(align(_ALIGN)) FP   dYY;
-    __declspec(align(_ALIGN)) FP   AAA;
     __declspec(align(_ALIGN)) FP   dtdx;
     __declspec(align(_ALIGN)) FP   dtdy;
     __declspec(align(_ALIGN)) FP   dyy;
     __declspec(align(_ALIGN)) FP   dxx;
     __declspec(align(_ALIGN)) FP   dx_1;       // 1/dx
     __declspec(align(_ALIGN)) FP   dy_1;       // 1/dy
-    __declspec(align(_ALIGN)) FP   dx_1_n_n_1; // 1/(2*dx)
-    __declspec(align(_ALIGN)) FP   dy_1_m_m_1; // 1/(2*dy)
-    __declspec(align(_ALIGN)) FP   DD_local[FlowNode2D<FP,NUM_COMPONENTS>::NumEq];
     __declspec(align(_ALIGN)) FP   DD[FlowNode2D<FP,NUM_COMPONENTS>::NumEq];
-    __declspec(align(_ALIGN)) FP   n_n;
-    __declspec(align(_ALIGN)) FP   m_m;
-    __declspec(align(_ALIGN)) FP   n_n_1;
-    __declspec(align(_ALIGN)) FP   m_m_1;
     __declspec(align(_ALIGN)) FP   beta_Scenario_Val; 
     __declspec(align(_ALIGN)) FP   CFL_Scenario_Val;  
 #else
-    FlowNode2D< FP,NUM_COMPONENTS >* CurrentNode  __attribute__ ((aligned (_ALIGN)))=NULL;
-    FlowNodeCore2D< FP,NUM_COMPONENTS >* NextNode __attribute__ ((aligned (_ALIGN)))=NULL;
-    FlowNode2D< FP,NUM_COMPONENTS >* UpNode       __attribute__ ((aligned (_ALIGN)))=NULL;        // neast     
-    FlowNode2D< FP,NUM_COMPONENTS >* DownNode     __attribute__ ((aligned (_ALIGN)))=NULL;        // nodes     
-    FlowNode2D< FP,NUM_COMPONENTS >* LeftNode     __attribute__ ((aligned (_ALIGN)))=NULL;        // references
-    FlowNode2D< FP,NUM_COMPONENTS >* RightNode    __attribute__ ((aligned (_ALIGN)))=NULL;                    
-    FP   beta   __attribute__ ((aligned (_ALIGN)));  
-    FP   _beta  __attribute__ ((aligned (_ALIGN)));
-    FP   dXX    __attribute__ ((aligned (_ALIGN))); 
-    FP   dYY    __attribute__ ((aligned (_ALIGN))); 
-    FP   AAA    __attribute__ ((aligned (_ALIGN))); 
     FP   dtdx   __attribute__ ((aligned (_ALIGN)));
     FP   dtdy   __attribute__ ((aligned (_ALIGN)));
     FP   dyy    __attribute__ ((aligned (_ALIGN)));
     FP   dxx    __attribute__ ((aligned (_ALIGN)));
     FP   dx_1   __attribute__ ((aligned (_ALIGN)));
     FP   dy_1   __attribute__ ((aligned (_ALIGN)));
-    FP   dx_1_n_n_1 __attribute__ ((aligned (_ALIGN))); // 1/(2*dx)
-    FP   dy_1_m_m_1 __attribute__ ((aligned (_ALIGN))); // 1/(2*dy)
-    FP   DD_local[FlowNode2D<FP,NUM_COMPONENTS>::NumEq] __attribute__ ((aligned (_ALIGN)));
     FP   DD[FlowNode2D<FP,NUM_COMPONENTS>::NumEq] __attribute__ ((aligned (_ALIGN)));
-    FP   n_n   __attribute__ ((aligned (_ALIGN)));
-    FP   m_m   __attribute__ ((aligned (_ALIGN)));
-    FP   n_n_1 __attribute__ ((aligned (_ALIGN)));
-    FP   m_m_1 __attribute__ ((aligned (_ALIGN)));
     FP   beta_Scenario_Val __attribute__ ((aligned (_ALIGN)));
     FP   CFL_Scenario_Val  __attribute__ ((aligned (_ALIGN)));
 #endif //__ICC
-    unsigned int Num_Eq,n1,n2,n3,n4;
-    unsigned int j,k;
-    unsigned int StartXLocal,MaxXLocal;
+    unsigned int k;
+    volatile unsigned int StartXLocal;
+    unsigned int MaxXLocal;
     FP   d_time;
     FP   t,VCOMP;
     timeval  start, stop, mark1, mark2;
-    int  N1,N2,N3,N4;
-#ifdef _OPEN_MP
-    unsigned int i_max,j_max,k_max;
-#endif //_OPEN_MP
-#ifdef _MPI
-    unsigned int i_max,j_max,k_max;
-#endif //_MPI
 
 #ifdef __ICC
-    __declspec(align(_ALIGN)) FP   dt_min_local;
     __declspec(align(_ALIGN)) FP   max_RMS;
 #else
-    FP   dt_min_local __attribute__ ((aligned (_ALIGN)));
     FP   max_RMS __attribute__ ((aligned (_ALIGN)));
 #endif // __ICC
     
     int  k_max_RMS;
+    int  n_block = 1;                // iterations in current temporal block
+    // Set after ___try (setjmp) and read by cleanup, so volatile (see also MPI locals below)
+    FP* volatile          SubDomainTime = NULL;  // sweep time of subdomains (MPI - ranks) since last rebalancing
+    SweepTile2D* volatile Tiles         = NULL;  // tiles of task-based sweep
+    volatile int          n_tiles       = 0;
+    volatile int          n_ty          = 1;     // rows of tiles
+    SweepParam2D sp;
+    DEEPS2D_Kernel2D< FlowFieldSoA2D<FP,NUM_COMPONENTS> > SoA_Kernel;
+    DEEPS2D_Kernel2D< FlowFieldAoS2D<FP,NUM_COMPONENTS> > AoS_Kernel;
 #ifndef _MPI
     UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >*     pJ=NULL;
     UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >* pC=NULL;
-    FP*   dt_min;
-    int*  i_c;
-    int*  j_c;
+    ColumnResidual2D* ColRes;     // residuals of field columns
+    ColumnResidual2D* TB_ColRes;  // temporal blocking: residuals of field columns per level
+    int   n_col = (int)J->GetX();
 
 #ifdef __ICC
     __declspec(align(_ALIGN)) FP    dtmin;
@@ -616,10 +1524,6 @@ void DEEPS2D_Run(ofstream* f_stream
 #endif // __ICC
     
     unsigned long  sum_iRMS[FlowNode2D<FP,NUM_COMPONENTS>::NumEq];
-    UMatrix2D<FP>  RMS(FlowNode2D<FP,NUM_COMPONENTS>::NumEq,SubDomainArray->GetNumElements());
-    UMatrix2D<FP>  sumDiv(FlowNode2D<FP,NUM_COMPONENTS>::NumEq,SubDomainArray->GetNumElements());
-    UMatrix2D<int> iRMS(FlowNode2D<FP,NUM_COMPONENTS>::NumEq,SubDomainArray->GetNumElements());
-    UMatrix2D<FP>  DD_max(FlowNode2D<FP,NUM_COMPONENTS>::NumEq,SubDomainArray->GetNumElements());
 #else
 
 #ifdef __ICC
@@ -632,12 +1536,38 @@ void DEEPS2D_Run(ofstream* f_stream
 #endif // __ICC
     
     unsigned long iRMS[FlowNode2D<FP,NUM_COMPONENTS>::NumEq];
-    Var_pack DD_max[last_rank+1];
-#ifdef _MPI_NB
-    MPI::Request  HaloExchange[4];
-    MPI::Request  DD_Exchange[2*last_rank];
-#endif //_MPI_NB
-    unsigned int r_Overlap, l_Overlap;
+    Var_pack* DD_max = NULL;         // residuals and dt_min of rank, then p, T of monitor points
+    Var_pack* DD_all = NULL;         // DD_max reduced over all ranks (the same at all ranks)
+    Var_pack* volatile TileDD = NULL; // residuals of tiles of rank
+    FP   sweep_time = 0.;            // sweep time of rank in current cycle
+    int  n_mon      = MonitorPointsArray ? (int)MonitorPointsArray->GetNumElements() : 0;
+    int  ReduceSize = sizeof(Var_pack)+2*n_mon*sizeof(FP);
+    MPI::Datatype ReduceType;              // DD_max with monitor values (see ReduceVarPack2D())
+    MPI::Op       ReduceOp;
+#if MPI_VERSION >= 3
+    MPI_Request   ReduceRequest;           // reduction is in flight during halo exchange
+#endif // MPI_VERSION >= 3
+    MPI::Prequest HaloRequest[8];          // persistent requests of halo exchange (see InitHaloRequests2D())
+    volatile int  n_halo   = 0;
+    int           n_halo_x = 0;            // requests of halo columns (first in HaloRequest[])
+    int           n_halo_start = 0;        // requests started before wait (rest - corners of deep halo)
+    int           n_halo_wait  = 0;        // halo exchanges in current cycle
+    SweepTile2D** volatile GhostTiles    = NULL; // GhostTiles[e] - tiles of own nodes and e halo columns/rows
+    int* volatile          n_ghost_tiles = NULL; // (e > 0, deep halo blocks, see HaloDepth)
+    int* volatile          n_gty         = NULL;
+    SweepTile2D* volatile  InnerTiles = NULL;    // tiles of interior nodes (halo exchange overlap)
+    volatile int           n_inner    = 0;
+    volatile int           n_ity      = 1;
+    timeval       halo_post;               // start of halo exchange in current iteration
+    FP            halo_wait_time    = 0.;  // wait for halo exchange in current cycle
+    FP            halo_overlap_time = 0.;  // computation between start of halo exchange and wait
+    volatile unsigned int r_Overlap, l_Overlap, u_Overlap, d_Overlap;   // halo width at each side (0 - no neighbor)
+    int          StartYLocal, MaxYLocal;   // own rows of local field
+    Block2D      Block;                    // block of rank in process grid
+    MPI::Datatype HaloNodeType;            // fields of node sent to neighbors
+    MPI::Datatype ColType;                 // halo columns (exchange with left/right neighbors)
+    MPI::Datatype RowType;                 // halo rows (exchange with up/down neighbors)
+    int           HaloNodeBytes;           // bytes of node in halo exchange
 #endif // _MPI
     isScan = 0;
     dyy    = dx/(dx+dy);
@@ -646,20 +1576,35 @@ void DEEPS2D_Run(ofstream* f_stream
     dx2    = dx*dx;
     dy2    = dy*dy;
     t      = 0;
-    n1 = n2 = n3 = n4 = 1;
     d_time = 0.;
 #ifndef _MPI
-    dt_min = new FP[SubDomainArray->GetNumElements()];
-    i_c    = new int[SubDomainArray->GetNumElements()];
-    j_c    = new int[SubDomainArray->GetNumElements()];
-#endif // _MPI
+    if(TileX > 0 && TemporalBlock == 1) {
+       n_tiles      = DEEPS2D_SetTiles(&Tiles,&n_ty,TileX,TileY,SubDomainArray,CoreSubDomainArray,0,0,0,(int)MaxY);
+       isFusedSweep = 0;           // tiles are swept in two passes
+    }
+
+    ColRes    = NewColumnResidual2D(n_ty*n_col);
+    TB_ColRes = NewColumnResidual2D(TemporalBlock*n_col);
+
+    if(ColRes == NULL || TB_ColRes == NULL) {
+       *f_stream << "\nERROR: Can't allocate residuals of " << n_col << " columns.\n" << flush;
+       Abort_OpenHyperFLOW2D();
+    }
+
+    dtmin = dt;
+
+    if(RebalanceStep > 0 &&
+       (n_tiles > 0 || TemporalBlock > 1 || GlobalSubDomain->GetNumElements() < 2)) {
+       *f_stream << "\nWARNING: RebalanceStep is ignored, sweep isn't split by subdomains (TileX > 0, TemporalBlock > 1 or single subdomain).\n" << flush;
+       RebalanceStep = 0;
+    }
+
+    if(RebalanceStep > 0) {
+       SubDomainTime = new FP[GlobalSubDomain->GetNumElements()];
+       for(int ii=0;ii<(int)GlobalSubDomain->GetNumElements();ii++)
+           SubDomainTime[ii] = 0.;
+    }
 
-#ifndef _MPI
-    
-    for(int ii=0;ii<(int)SubDomainArray->GetNumElements();ii++) {
-        dt_min[ii] = dtmin = dt;
-        i_c[ii] = j_c[ii] = 0;
-     }
     snprintf(RMSFileName,255,"RMS-%s",OutFileName);
     CutFile(RMSFileName);
     pRMS_OutFile = OpenData(RMSFileName);
@@ -687,8 +1632,19 @@ void DEEPS2D_Run(ofstream* f_stream
         }
     }
 
-    for (int ii=0;(int)ii<last_rank+1;ii++)
-         DD_max[ii].dt_min=dt;
+    DD_max = (Var_pack*)new char[2*ReduceSize];
+    DD_all = (Var_pack*)((char*)DD_max+ReduceSize);
+    DD_all->dt_min = DD_max->dt_min = dt;
+
+    ReduceType = MPI::BYTE.Create_contiguous(ReduceSize);
+    ReduceType.Commit();
+    ReduceOp.Init(ReduceVarPack2D,true);
+
+    if(RebalanceStep > 0 && rank == 0) {
+       SubDomainTime = new FP[ProcGridX];
+       for(int ii=0;ii<ProcGridX;ii++)
+           SubDomainTime[ii] = 0.;
+    }
 #endif // _MPI
 #ifdef _DEBUG_0
           ___try {
@@ -697,18 +1653,69 @@ void DEEPS2D_Run(ofstream* f_stream
                     I = 0;
                     isRun = 1;
 #ifdef _MPI
-                    if( rank == 0) {
-                        StartXLocal = l_Overlap = 0;
-                    } else {
-                        StartXLocal = l_Overlap = 1;
-                    }
+                    GetBlock2D(rank,&Block);
+                    l_Overlap = HaloDepth*(Block.left  != MPI::PROC_NULL);
+                    r_Overlap = HaloDepth*(Block.right != MPI::PROC_NULL);
+                    d_Overlap = HaloDepth*(Block.down  != MPI::PROC_NULL);
+                    u_Overlap = HaloDepth*(Block.up    != MPI::PROC_NULL);
+
+                    // HaloDepth iterations between halo exchanges, level e levels before
+                    // end of block computes own nodes and e halo columns/rows
+                    TemporalBlock = HaloDepth;
+                    if(HaloDepth > 1)
+                       isPackedHalo = 0;           // halo nodes are computed by rank (all fields)
+
+                    StartXLocal = l_Overlap;
+                    MaxXLocal   = l_Overlap+Block.i_end-Block.i_start;
+                    StartYLocal = d_Overlap;
+                    MaxYLocal   = d_Overlap+Block.j_end-Block.j_start;
+
+                    if(last_rank == 0)
+                       isHaloOverlap = 0;          // no neighbors
+                    else if(isHaloOverlap)
+                       isFusedSweep  = 0;          // edge nodes are updated before interior nodes
+
+                    if(TileX > 0) {
+                       // OpenMP threads of rank sweep tiles of local field
+                       UArray<UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >*>     RankSubDomain;
+                       UArray<UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >*> RankCoreSubDomain;
+
+                       RankSubDomain.AddElement(&pJ);
+                       RankCoreSubDomain.AddElement(&pC);
+                       n_tiles      = DEEPS2D_SetTiles(&Tiles,&n_ty,TileX,TileY,&RankSubDomain,&RankCoreSubDomain,
+                                                       l_Overlap,r_Overlap,StartYLocal,MaxYLocal);
+                       if(isHaloOverlap &&
+                          MaxXLocal-StartXLocal > l_Overlap+r_Overlap &&
+                          MaxYLocal-StartYLocal > (int)(d_Overlap+u_Overlap))
+                          n_inner   = DEEPS2D_SetTiles(&InnerTiles,&n_ity,TileX,TileY,&RankSubDomain,&RankCoreSubDomain,
+                                                       2*l_Overlap,2*r_Overlap,StartYLocal+d_Overlap,MaxYLocal-u_Overlap);
+                       isFusedSweep = 0;           // tiles are swept in two passes
+                       int n_dd     = n_tiles+n_inner;
+
+                       GhostTiles    = new SweepTile2D*[HaloDepth];
+                       n_ghost_tiles = new int[HaloDepth];
+                       n_gty         = new int[HaloDepth];
+                       GhostTiles[0]    = NULL;
+                       n_ghost_tiles[0] = 0;
+                       for(int e=1;e<HaloDepth;e++) {
+                           const int el = min(e,(int)l_Overlap), er = min(e,(int)r_Overlap);
+                           n_ghost_tiles[e] = DEEPS2D_SetTiles(&GhostTiles[e],&n_gty[e],TileX,TileY,&RankSubDomain,&RankCoreSubDomain,
+                                                               l_Overlap-el,r_Overlap-er,
+                                                               StartYLocal-min(e,(int)d_Overlap),MaxYLocal+min(e,(int)u_Overlap));
+                           n_dd += n_ghost_tiles[e];
+                       }
 
-                    if( rank == last_rank) {
-                        MaxXLocal=pJ->GetX();
-                        r_Overlap = 0;
-                    } else {
-                        MaxXLocal=pJ->GetX()-1;
-                        r_Overlap = 1;
+                       TileDD       = new Var_pack[n_dd];
+                       for(int t=0;t<n_dd;t++)
+                           ClearVarPack2D(TileDD+t);
+                       for(int t=0;t<n_tiles;t++)
+                           Tiles[t].DD_max = TileDD+t;
+                       for(int t=0;t<n_inner;t++)
+                           InnerTiles[t].DD_max = TileDD+n_tiles+t;
+                       n_dd = n_tiles+n_inner;
+                       for(int e=1;e<HaloDepth;e++)
+                           for(int t=0;t<n_ghost_tiles[e];t++)
+                               GhostTiles[e][t].DD_max = TileDD+(n_dd++);
                     }
 #else
                     pJ    = J;
@@ -719,10 +1726,104 @@ void DEEPS2D_Run(ofstream* f_stream
                     
                     dx_1 = 1.0/dx;
                     dy_1 = 1.0/dy;
+
+                    if(FieldStorage == FST_SOA) {
+#ifdef _MPI
+                       SoA_Field = new FlowFieldSoA2D<FP,NUM_COMPONENTS>(pJ);
+                       if( rank == 0 )
+#else
+                       SoA_Field = new FlowFieldSoA2D<FP,NUM_COMPONENTS>(J);
+#endif // _MPI
+                       *f_stream << "Field storage: SoA (" << SoA_Field->GetPoolSize()/(1024*1024) << " Mb)\n" << flush;
+                    }
+#ifdef _MPI
+                    BCMask    = new BCMaskTable2D<FP,NUM_COMPONENTS>(pJ,ProblemType);
+                    NodeSpans = new NodeSpanList2D<FP,NUM_COMPONENTS>(pJ,BCMask);
+                    if( rank == 0 )
+#else
+                    BCMask    = new BCMaskTable2D<FP,NUM_COMPONENTS>(J,ProblemType);
+                    NodeSpans = new NodeSpanList2D<FP,NUM_COMPONENTS>(J,BCMask);
+#endif // _MPI
+                    *f_stream << "BC mask table: " << BCMask->GetTableSize()/1024 << " Kb\n"
+                              << "Active nodes: " << NodeSpans->GetNumNodes(NST_GAS) << " in "
+                              << NodeSpans->GetNumSpans(NST_GAS) << " spans ("
+                              << NodeSpans->GetNumNodes(NST_FC) << " fixed, "
+                              << NodeSpans->GetNumNodes(NST_WALL) << " wall, "
+                              << NodeSpans->GetNumNodes(NST_NONREFLECTED) << " non-reflected nodes)\n" << flush;
+
+                    // Vectorized kernel works with SoA field of double only
+                    if(FieldStorage != FST_SOA || sizeof(FP) != sizeof(double))
+                       SIMDKernel = SIMD_NONE;
+#ifdef _MPI
+                    if( rank == 0 )
+#endif // _MPI
+                    {
+                      *f_stream << "Sweep: " << (isFusedSweep ? "fused (single pass)" : "two-pass");
+                      if(TemporalBlock > 1)
+                         *f_stream << ", temporal blocks of " << TemporalBlock << " iterations";
+                      if(n_tiles > 0)
+                         *f_stream << ", tiled " << TileX << "x" << (TileY > 0 ? TileY : (int)MaxY)
+                                   << " (" << n_tiles << " tiles)";
+#if defined(_MPI) && defined(_OPENMP)
+                      *f_stream << ", " << omp_get_max_threads() << " OpenMP threads per rank";
+#endif // _MPI && _OPENMP
+                      if(isBatchFill)
+                         *f_stream << ", batched FillNode2D";
+#ifdef _MPI
+                      if(RebalanceStep > 0)
+                         *f_stream << ", cost of columns saved every " << RebalanceStep << " cycles (for next start)";
+#else
+                      if(RebalanceStep > 0)
+                         *f_stream << ", rebalance every " << RebalanceStep << " cycles";
+                      if(isGlobalTimeStep)
+                         *f_stream << ", one dt for all subdomains";
+#endif // _MPI
+#ifdef _MPI
+                      if(isHaloOverlap)
+                         *f_stream << ", halo exchange overlapped with interior nodes";
+                      if(HaloDepth > 1)
+                         *f_stream << ", halo depth " << HaloDepth;
+#endif // _MPI
+                      if(NumSpeciesEq == 0)
+                         *f_stream << ", single gas (no species equations)";
+                      *f_stream << "\n"
+                                << "SIMD kernel: " << GetSIMDName(SIMDKernel) << " ("
+                                << NodeSpans->GetNumNodes(NST_INTERIOR) << " interior nodes in "
+                                << NodeSpans->GetNumSpans(NST_INTERIOR) << " spans)\n" << flush;
+                    }
+
+                    SoA_Kernel.Select(ProblemType,FlowNode2D<FP,NUM_COMPONENTS>::FT,bFF,BCMask->isTurbulenceEq(),NumSpeciesEq);
+                    AoS_Kernel.Select(ProblemType,FlowNode2D<FP,NUM_COMPONENTS>::FT,bFF,BCMask->isTurbulenceEq(),NumSpeciesEq);
+#ifdef _MPI
+                    {
+                      // halo nodes have the same fields at both sides of exchange
+                      int is_turb_eq = BCMask->isTurbulenceEq();
+                      int turb_eq    = 0;
+
+                      MPI::COMM_WORLD.Allreduce(&is_turb_eq,&turb_eq,1,MPI::INT,MPI::MAX);
+                      HaloNodeType = CreateHaloNodeType2D(&pJ->GetValue(0,0),isPackedHalo,ProblemType,
+                                                          turb_eq,NumSpeciesEq,!isAdiabaticWall,&HaloNodeBytes);
+                    }
+
+                    n_halo = InitHaloRequests2D(HaloRequest,&n_halo_x,pJ,&Block,StartXLocal,MaxXLocal,StartYLocal,MaxYLocal,
+                                                HaloDepth,HaloNodeType,&ColType,&RowType);
+                    // deep halo: rows with corners are exchanged after columns
+                    n_halo_start = (HaloDepth > 1 && n_halo_x > 0) ? n_halo_x : n_halo;
+
+                    if( rank == 0 )
+                       *f_stream << "Halo exchange: " << HaloNodeBytes << " of "
+                                 << sizeof(FlowNode2D<FP,NUM_COMPONENTS>) << " bytes per node\n" << flush;
+
+                    if( rank == 0 )
+#endif // _MPI
+                    StartSnapshotWriter2D(f_stream);
                     
              do {
                   gettimeofday(&mark2,NULL);
                   gettimeofday(&start,NULL);
+
+                  if(FieldStorage == FST_SOA)
+                     SoA_Field->Gather();
                   
                   if( AddSrcStartIter < iter + last_iter){
                     FlowNode2D<FP,NUM_COMPONENTS>::isSrcAdd = 1;
@@ -734,42 +1835,32 @@ void DEEPS2D_Run(ofstream* f_stream
                   
                   do {
                       
+                      // block ends at output step (same monitor/RMS steps as without blocking)
+                      n_block           = min(TemporalBlock,Nstep-(int)iter);
+                      n_block           = min(n_block,(int)((iter+NOutStep-1)/NOutStep*NOutStep-iter)+1);
                       beta_Scenario_Val = beta_Scenario->GetVal(iter+last_iter); 
                       CFL_Scenario_Val  = CFL_Scenario->GetVal(iter+last_iter); 
 #ifdef _MPI
 // MPI version
-                      if(rank == 0 ) {
-                          max_RMS =  0;
-                      } else {
-                        if(MonitorIndex < 5)
-                           max_RMS = 0;
-                        else
-                           max_RMS = 0.5*ExitMonitorValue;
-                      }
-
+                  max_RMS   =  0;                                               // residuals of all ranks at every rank
                   k_max_RMS = -1;
 
                   for (int kk=0;kk<FlowNode2D<FP,NUM_COMPONENTS>::NumEq;kk++ ) {
-                      RMS[kk]    = 0.;                                         // Clean sum residual
-                      iRMS[kk]   = 0;                                          // num involved nodes
-                      sumDiv[kk] = 0.;
-                      
-                      DD_max[rank].DD[kk].RMS    = 0.;                          // sum residual per rank
-                      DD_max[rank].DD[kk].iRMS   = 0;                           // num involved nodes per rank
-                      DD_max[rank].DD[kk].sumDiv = 0;                           // sum Div param
-                      DD_max[rank].DD[kk].DD     = 0.;                          // max residual per rank
-                      DD_max[rank].DD[kk].i      = 0;                           // max residual x-coord
-                      DD_max[rank].DD[kk].j      = 0;                           // max residual y-coord
-                      DD_local[kk]               = 0.;                          // local residual
+                      DD_max->DD[kk].RMS    = 0.;                               // sum residual per rank
+                      DD_max->DD[kk].iRMS   = 0;                                // num involved nodes per rank
+                      DD_max->DD[kk].sumDiv = 0;                                // sum Div param
+                      DD_max->DD[kk].DD     = 0.;                               // max residual per rank
+                      DD_max->DD[kk].i      = 0;                                // max residual x-coord
+                      DD_max->DD[kk].j      = 0;                                // max residual y-coord
                     }
 #else
                    n_s = (int)SubDomainArray->GetNumElements();
 #ifdef _OPENMP
 #pragma omp parallel shared(f_stream,CoreSubDomainArray, SubDomainArray, chemical_reactions,Y_mix,sum_RMS, sum_iRMS, \
-                            Cp,i_max,j_max,k_max,Tg,beta0,CurrentTimePart,DD,dx,dy,MaxX,MaxY,dt_min,RMS,iRMS,DD_max,i_c,j_c,n_s) \
-                     private(iter,j,k,n1,n2,n3,n4,N1,N2,N3,N4,n_n,m_m,pC,pJ,err_i,err_j,\
-                             dXX,dYY,DD_local,AAA,StartXLocal,MaxXLocal,\
-                             dtdx,dtdy,dt) reduction(min: dtmin)
+                            Cp,Tg,beta0,CurrentTimePart,DD,dx,dy,MaxX,MaxY,ColRes,TB_ColRes,n_s) \
+                     private(iter,k,pC,pJ,err_i,err_j,\
+                             StartXLocal,MaxXLocal,\
+                             dtdx,dtdy,dt)
 //#pragma omp single
 #endif //_OPENMP
                    {
@@ -782,52 +1873,31 @@ void DEEPS2D_Run(ofstream* f_stream
                     k_max_RMS = -1;
 
                     for ( k=0;k<(int)FlowNode2D<FP,NUM_COMPONENTS>::NumEq;k++ ) {
-                           for(int ii=0;ii<n_s;ii++) {
-                               RMS(k,ii)    = 0.;    // Clean sum residual
-                               iRMS(k,ii)   = 0;     // num involved nodes
-                               sumDiv(k,ii) = 0;     // sum div params 
-                           }
                            sum_iRMS[k] = 0;
                            sum_RMS_Div[k] = sum_RMS[k] = DD[k] = 0.;
                        }
                    }
 #endif //_MPI
-#ifdef _OPENMP
-#pragma omp for private(CurrentNode,NextNode,UpNode,DownNode,LeftNode,RightNode) ordered nowait 
+#if defined(_OPENMP) && !defined(_MPI)
+#pragma omp for private(sp) ordered nowait 
                 for(int ii=0;ii<n_s;ii++) {  // OpenMP version
 #endif //_OPENMP
 
 #ifndef _MPI
 #ifndef _OPENMP
                     int ii = 0;                                                    // Single thread version
-                    dt = dt_min[0];
 #endif //_OPENMP
+                    dt = dtmin;                                                    // minimal dt of previous iterations (and subdomains)
 #else
-                     dt  = 1.;
-                     for (int ii=0;(int)ii<last_rank+1;ii++) {                  // Choose
-                         dt  = min(DD_max[ii].dt_min,dt);                       // minimal
-                    }
-
+                    dt = DD_all->dt_min;                                           // minimal dt of all ranks
 #endif // _MPI
 
-#ifdef _OPENMP
-                   dt    = dtmin;
-                   
-                   i_c[ii] = j_c[ii] = 0;
-#endif //_OPENMP
-
 #ifndef _MPI
                     pJ = SubDomainArray->GetElement(ii);
                     pC = CoreSubDomainArray->GetElement(ii);
 #endif // _MPI
 
-#ifdef _MPI
-                    MPI::COMM_WORLD.Bcast(&dt,1,MPI::DOUBLE,0);
-#else
-                    for ( k=0;k<(int)FlowNode2D<FP,NUM_COMPONENTS>::NumEq;k++ ) {
-                         DD_max(k,ii) =  0.;
-                      }
-
+#ifndef _MPI
                     if( ii == 0)
                        StartXLocal=0;
                     else
@@ -843,691 +1913,267 @@ void DEEPS2D_Run(ofstream* f_stream
                     dtdx = dt/dx;
                     dtdy = dt/dy;
 
-#ifdef _OPENMP
-                    dt_min[ii]   = 1.;
-#else
 #ifdef _MPI
-                    DD_max[rank].dt_min = dt_min_local = 1.;
+                    DD_max->dt_min = 1.;
 #endif // _MPI
-#endif // _OPENMP
-                    for (int i = StartXLocal;i<(int)MaxXLocal;i++ ) {
-                       for (int j=0;j<(int)MaxY;j++ ) {
-                          
-                          err_i = i;
-                          err_j = j;
-
-                          CurrentNode = &(pJ->GetValue(i,j)); 
-
-                          if ( CurrentNode->isCond2D(CT_NODE_IS_SET_2D) &&
-                              !CurrentNode->isCond2D(CT_SOLID_2D)  &&
-                              !CurrentNode->isCond2D(NT_FC_2D)) {
-
-                                NextNode    = &(pC->GetValue(i,j)); 
-
-                                CurrentNode->time=GlobalTime;
-
-                                n1=CurrentNode->idXl;
-                                n2=CurrentNode->idXr;
-                                n3=CurrentNode->idYu;
-                                n4=CurrentNode->idYd;
-
-                                N1 = i - n1;
-                                N2 = i + n2;
-                                N3 = j + n3;
-                                N4 = j - n4;
-
-                                n_n = max(n1+n2,1);
-                                m_m = max(n3+n4,1);
-
-                                n_n_1 = 1./n_n;
-                                m_m_1 = 1./m_m;
-
-                                UpNode    = &(pJ->GetValue(i,N3));
-                                DownNode  = &(pJ->GetValue(i,N4));
-                                RightNode = &(pJ->GetValue(N2,j));
-                                LeftNode  = &(pJ->GetValue(N1,j));
-
-                                Num_Eq =  (FlowNode2D<FP,NUM_COMPONENTS>::NumEq-SetTurbulenceModel(CurrentNode));
-                                
-                                // Scan equation system ... k - number of equation
-                                for (int k=0;k<Num_Eq;k++ ) {
-                                        int      c_flag = 0;
-                                        int      dx_flag, dx2_flag;
-                                        int      dy_flag, dy2_flag;
-                                        
-                                        beta  = CurrentNode->beta[k];
-                                        _beta = 1. - beta;
-
-                                // Precomputed variables for current node ...
-                                        c_flag  = dx_flag = dy_flag = dx2_flag = dy2_flag = 0;
-                                    if ( k < 4 ) { // Make bit flags for future test for current equation
-                                        c_flag   = CT_Rho_CONST_2D     << k; 
-                                        dx_flag  = CT_dRhodx_NULL_2D   << k;
-                                        dy_flag  = CT_dRhody_NULL_2D   << k;
-                                        dx2_flag = CT_d2Rhodx2_NULL_2D << k;
-                                        dy2_flag = CT_d2Rhody2_NULL_2D << k;
-                                    } else if (k < (4+NUM_COMPONENTS)) {
-                                        c_flag   = CT_Y_CONST_2D;
-                                        dx_flag  = CT_dYdx_NULL_2D;
-                                        dy_flag  = CT_dYdy_NULL_2D;
-                                        dx2_flag = CT_d2Ydx2_NULL_2D;
-                                        dy2_flag = CT_d2Ydy2_NULL_2D;
-                                    } else if (ProblemType == SM_NS && 
-                                               (CurrentNode->isTurbulenceCond2D(TCT_k_eps_Model_2D) ||
-                                                CurrentNode->isTurbulenceCond2D(TCT_Spalart_Allmaras_Model_2D))) { //
-                                      if( k == i2d_k) {
-                                          c_flag   = TCT_k_CONST_2D     << (k-4-NUM_COMPONENTS); 
-                                          dx_flag  = TCT_dkdx_NULL_2D   << (k-4-NUM_COMPONENTS);
-                                          dy_flag  = TCT_dkdy_NULL_2D   << (k-4-NUM_COMPONENTS);
-                                          dx2_flag = TCT_d2kdx2_NULL_2D << (k-4-NUM_COMPONENTS);
-                                          dy2_flag = TCT_d2kdy2_NULL_2D << (k-4-NUM_COMPONENTS);
-                                      } else if (k == i2d_eps) {
-                                          c_flag   = TCT_eps_CONST_2D     << (k-4-NUM_COMPONENTS); 
-                                          dx_flag  = TCT_depsdx_NULL_2D   << (k-4-NUM_COMPONENTS);
-                                          dy_flag  = TCT_depsdy_NULL_2D   << (k-4-NUM_COMPONENTS);
-                                          dx2_flag = TCT_d2epsdx2_NULL_2D << (k-4-NUM_COMPONENTS);
-                                          dy2_flag = TCT_d2epsdy2_NULL_2D << (k-4-NUM_COMPONENTS);
-                                      }
-                                    }
-                                    // Check BC for current equation
-                                    if (k<(4+NUM_COMPONENTS)) {
-
-                                        if ( CurrentNode->isCond2D((CondType2D)c_flag) )
-                                            c_flag  = 0;
-                                        else
-                                            c_flag  = 1;
-
-                                        if ( CurrentNode->isCond2D((CondType2D)dx_flag) ) {
-                                            dx_flag = 0;
-                                        } else {
-                                            dx_flag = 1;
-                                        }
-
-                                        if ( CurrentNode->isCond2D((CondType2D)dy_flag) ) {
-                                            dy_flag = 0;
-                                        } else {
-                                            dy_flag = 1;
-                                        }
-
-                                        if ( CurrentNode->isCond2D((CondType2D)dx2_flag) ) {
-                                            dx2_flag = 1;
-                                        } else {
-                                            dx2_flag = 0;
-                                        }
-
-                                        if ( CurrentNode->isCond2D((CondType2D)dy2_flag) ) {
-                                            dy2_flag = 1;
-                                        } else {
-                                            dy2_flag = 0;
-                                        }
-                                    } else if(ProblemType == SM_NS && 
-                                              (CurrentNode->isTurbulenceCond2D(TCT_k_eps_Model_2D) ||
-                                               CurrentNode->isTurbulenceCond2D(TCT_Spalart_Allmaras_Model_2D)) ) {
-                                        if ( CurrentNode->isTurbulenceCond2D((TurbulenceCondType2D)c_flag) )
-                                            c_flag  = 0;
-                                        else
-                                            c_flag  = 1;
-
-                                        if ( CurrentNode->isTurbulenceCond2D((TurbulenceCondType2D)dx_flag) ) {
-                                            dx_flag = 0;
-                                        } else {
-                                            dx_flag = 1;
-                                        }
-                                        if ( CurrentNode->isTurbulenceCond2D((TurbulenceCondType2D)dy_flag) ) {
-                                            dy_flag = 0;
-                                        } else {
-                                            dy_flag = 1;
-                                        }
-                                        if ( CurrentNode->isTurbulenceCond2D((TurbulenceCondType2D)dx2_flag) ) {
-                                            dx2_flag = 1;
-                                        } else {
-                                            dx2_flag = 0;
-                                        }
-                                        if ( CurrentNode->isTurbulenceCond2D((TurbulenceCondType2D)dy2_flag) ) {
-                                            dy2_flag = 1;
-                                        } else {
-                                            dy2_flag = 0;
-                                        }
-                                    }
-
-                                    if ( c_flag ) {
-
-                                        if ( dx_flag ) {
-                                            dXX = CurrentNode->dSdx[k] = (RightNode->A[k]-LeftNode->A[k])*n_n_1;
-                                        } else {
-                                            CurrentNode->S[k] = (LeftNode->S[k]*n2+RightNode->S[k]*n1)*n_n_1;
-                                            dXX = CurrentNode->dSdx[k] = 0.;
-                                        }
-                                        if ( dy_flag ) {
-                                            dYY = CurrentNode->dSdy[k] = (UpNode->B[k]-DownNode->B[k])*m_m_1;
-
-                                        } else {
-                                            CurrentNode->S[k] =  (UpNode->S[k]*n3+DownNode->S[k]*n4)*m_m_1;
-                                            dYY = CurrentNode->dSdy[k] = 0;
-                                        }
-                                        if ( dx2_flag ) {
-                                            dXX = (LeftNode->dSdx[k]+RightNode->dSdx[k])*0.5;
-                                        }
-                                        if ( dy2_flag ) {
-                                            dYY = (UpNode->dSdy[k]+DownNode->dSdy[k])*0.5;
-                                        }
-
-                                        if ( CurrentNode->FT ) {
-                                            NextNode->S[k] = CurrentNode->S[k]*beta+_beta*(dxx*(LeftNode->S[k]+RightNode->S[k])+dyy*(UpNode->S[k]+DownNode->S[k]))*0.5
-                                                           - (dtdx*dXX+dtdy*(dYY+CurrentNode->F[k]/(j+1))) + (CurrentNode->Src[k])*dt+CurrentNode->SrcAdd[k];
-                                        } else {
-                                            NextNode->S[k] = CurrentNode->S[k]*beta+_beta*(dxx*(LeftNode->S[k]+RightNode->S[k])+dyy*(UpNode->S[k]+DownNode->S[k]))*0.5
-                                                           - (dtdx*dXX+dtdy*dYY) + (CurrentNode->Src[k])*dt+CurrentNode->SrcAdd[k];
-                                        }
-                               }
-                         }
-                     }
-                  }
-               }
-                   
-               for (int i=StartXLocal;i<(int)MaxXLocal;i++ ) {
-                 for ( j=0;j<MaxY;j++ ) {
-
-                          CurrentNode = &(pJ->GetValue(i,j)); 
-
-                          if (CurrentNode->isCond2D(CT_NODE_IS_SET_2D) &&
-                              !CurrentNode->isCond2D(CT_SOLID_2D) &&
-                              !CurrentNode->isCond2D(NT_FC_2D)) {
-
-                              NextNode    = &(pC->GetValue(i,j)); 
-                              
-                              n1=CurrentNode->idXl;
-                              n2=CurrentNode->idXr;
-                              n3=CurrentNode->idYu;
-                              n4=CurrentNode->idYd;
-
-                              N1 = i - n1;
-                              N2 = i + n2;
-                              N3 = j + n3;
-                              N4 = j - n4;
-
-                              UpNode     = &(pJ->GetValue(i,N3));
-                              DownNode   = &(pJ->GetValue(i,N4));
-                              RightNode  = &(pJ->GetValue(N2,j));
-                              LeftNode   = &(pJ->GetValue(N1,j));
-
-                              n_n = max(n1+n2,1);
-                              m_m = max(n3+n4,1);
-
-                              dx_1_n_n_1 = dx_1/n_n; 
-                              dy_1_m_m_1 = dy_1/m_m;
-                              
-                              Num_Eq = (FlowNode2D<FP,NUM_COMPONENTS>::NumEq-SetTurbulenceModel(CurrentNode));
-
-                              for (int k=0;k<Num_Eq;k++ ) {
-
-                                  int c_flag = 0;
-
-                                  if ( k < 4 ) // Make bit flags for future test for current equation // FlowNode2D<FP,NUM_COMPONENTS>::NumEq-AddEq-NUM_COMPONENTS ?
-                                      c_flag  = CT_Rho_CONST_2D   << k;
-                                  else if (k<(4+NUM_COMPONENTS))  // 7 ?
-                                      c_flag  = CT_Y_CONST_2D;
-                                  else if( ProblemType == SM_NS  &&
-                                          (CurrentNode->isTurbulenceCond2D(TCT_k_eps_Model_2D) ||
-                                           CurrentNode->isTurbulenceCond2D(TCT_Spalart_Allmaras_Model_2D) )) 
-                                      c_flag  = TCT_k_CONST_2D << (k-4-NUM_COMPONENTS); 
-
-                                  if ( !CurrentNode->isCond2D((CondType2D)c_flag) && 
-                                        CurrentNode->S[k] != 0. ) {
-
-                                        FP Tmp;
-                                        FP beta_min;
-                                        FP sqrt_RES = 0;
-                                        FP absDD    = 0.;
-
-                                        if(k == i2d_RhoU && k == i2d_RhoV ) {
-                                            Tmp = max(fabs(CurrentNode->S[i2d_RhoU]),fabs(CurrentNode->S[i2d_RhoV]));// max Flux
-                                        } else {
-                                           Tmp = CurrentNode->S[k];
-                                        }
-                                        
-                                        absDD       = NextNode->S[k]-CurrentNode->S[k];
-                                        
-                                        if(fabs(Tmp) > 1.e-15) {
-                                            DD_local[k] = fabs(absDD/Tmp);
-                                            sqrt_RES    = sqrt(DD_local[k]);
-                                        } else {
-                                            DD_local[k] = 1.0;
-                                        }
-
-                                        beta_min = min(beta0,beta_Scenario_Val);
-
-                                        if(CurrentNode->isCond2D(CT_NONREFLECTED_2D)) {
-                                           beta_min = nrbc_beta0;
-                                        }
-
-                                        if( bFF == BFF_L) {
-                                        //LINEAR locally adopted blending factor function  (LLABFF)
-                                          CurrentNode->beta[k] = min(beta_min,(beta_min*beta_min)/(beta_min+DD_local[k]));
-                                        } else if( bFF == BFF_LR) {
-                                        //LINEAR locally adopted blending factor function with relaxation (LLABFFR)
-                                          CurrentNode->beta[k] = min((beta_min+CurrentNode->beta[k])*0.5,(beta_min*beta_min)/(beta_min+DD_local[k]));
-                                        } else if( bFF == BFF_S) {
-                                          //SQUARE locally adopted blending factor function (SLABF)
-                                          CurrentNode->beta[k] = min(beta_min,(beta_min*beta_min)/(beta_min+DD_local[k]*DD_local[k]));
-                                        } else if (bFF == BFF_SR) {
-                                          //SQUARE locally adopted blending factor function with relaxation (SLABFFR)
-                                          CurrentNode->beta[k] = min((beta_min+CurrentNode->beta[k])*0.5,(beta_min*beta_min)/(beta_min+DD_local[k]*DD_local[k]));
-                                        } else if( bFF == BFF_SQR) {
-                                        //SQRT() locally adopted blending factor function (SQRLABF) + most accurate & stable +
-                                          CurrentNode->beta[k] = min(beta_min,(beta_min*beta_min)/(beta_min+sqrt_RES));
-                                        } else if( bFF == BFF_SQRR) {
-                                          CurrentNode->beta[k] = min((beta_min+CurrentNode->beta[k])*0.5,(beta_min*beta_min)/(beta_min+sqrt_RES)); 
-                                        }
+                    sp.dt                = dt;
+                    sp.dtdx              = dtdx;
+                    sp.dtdy              = dtdy;
+                    sp.dxx               = dxx;
+                    sp.dyy               = dyy;
+                    sp.dx_1              = dx_1;
+                    sp.dy_1              = dy_1;
+                    sp.beta_Scenario_Val = beta_Scenario_Val;
+                    sp.CFL_Scenario_Val  = CFL_Scenario_Val;
+                    sp.StartXLocal       = StartXLocal;
+                    sp.MaxXLocal         = MaxXLocal;
 #ifdef _MPI
-                                        DD_max[rank].DD[k].DD      = max(DD_max[rank].DD[k].DD,DD_local[k]);
-                                        
-                                        if (isAlternateRMS) {
-                                            DD_max[rank].DD[k].RMS    += absDD*absDD;
-                                            DD_max[rank].DD[k].sumDiv += Tmp*Tmp;
-                                        } else {
-                                            DD_max[rank].DD[k].RMS    += DD_local[k]*DD_local[k];
-                                            DD_max[rank].DD[k].iRMS++;
-                                        }
-                                        
-                                          if (DD_max[rank].DD[k].DD==DD_local[k] ) {
-                                              DD_max[rank].DD[k].i = i;
-                                              DD_max[rank].DD[k].j = j;
-                                          }
+                    sp.StartYLocal       = StartYLocal;
+                    sp.MaxYLocal         = MaxYLocal;
 #else
-                                        if (isAlternateRMS) {
-                                             sumDiv(k,ii) += Tmp*Tmp;
-                                             RMS(k,ii)    += absDD;
-                                         } else {
-                                             RMS(k,ii)    += DD_local[k]*DD_local[k];
-                                         }
-                                        
-                                         iRMS(k,ii)++;
-                                        
-                                         DD_max(k,ii) = max(DD_max(k,ii),DD_local[k]);
-
-                                        if ( DD_max(k,ii) == DD_local[k] ) {
-                                             i_c[ii] = i;
-                                             j_c[ii] = j;
-                                        }
+                    sp.StartYLocal       = 0;
+                    sp.MaxYLocal         = (int)MaxY;
 #endif // _MPI
-                                        }
-                                        
-                                        if (k<(4+NUM_COMPONENTS)) {
-                                            if ( !CurrentNode->isCond2D((CondType2D)c_flag) )
-                                                  CurrentNode->S[k]   = NextNode->S[k];
-                                        } else if (ProblemType == SM_NS  &&
-                                                   (CurrentNode->isTurbulenceCond2D(TCT_k_eps_Model_2D) ||
-                                                    CurrentNode->isTurbulenceCond2D(TCT_Spalart_Allmaras_Model_2D)) ){
-                                            if ( !CurrentNode->isTurbulenceCond2D((TurbulenceCondType2D)c_flag) )
-                                                  CurrentNode->S[k]   =  NextNode->S[k];
-                                        }
-                                    }
-                                    
-                                    //CurrentNode->beta[i2d_RhoV] = CurrentNode->beta[i2d_RhoU] = max(CurrentNode->beta[i2d_RhoU],CurrentNode->beta[i2d_RhoV]);  // for symmetry keeping
-                                    
-                                    if(ProblemType == SM_NS) {
-
-                                        FP  rhoY_air_Right = RightNode->S[i2d_Rho];
-                                        FP  rhoY_air_Left  = LeftNode->S[i2d_Rho];
-                                        FP  rhoY_air_Up    = UpNode->S[i2d_Rho];
-                                        FP  rhoY_air_Down  = DownNode->S[i2d_Rho];
-                                        
-                                        CurrentNode->droYdx[NUM_COMPONENTS]=CurrentNode->droYdy[NUM_COMPONENTS]=0.;
-                                        
-                                        for (int k=4;k<FlowNode2D<FP,NUM_COMPONENTS>::NumEq-2;k++ ) {
-                                            if ( !CurrentNode->isCond2D(CT_dYdx_NULL_2D) ) {
-                                                CurrentNode->droYdx[k-4]=(RightNode->S[k]-LeftNode->S[k])*dx_1_n_n_1;
-                                                rhoY_air_Right -= RightNode->S[k];
-                                                rhoY_air_Left  -= LeftNode->S[k];
-                                            }
-                                            if ( !CurrentNode->isCond2D(CT_dYdy_NULL_2D) ) {
-                                                  CurrentNode->droYdy[k-4]=(UpNode->S[k]-DownNode->S[k])*dy_1_m_m_1;
-                                                  rhoY_air_Up    -= UpNode->S[k];
-                                                  rhoY_air_Down  -= DownNode->S[k];
-                                            }
-                                        }
-                                        
-                                        if ( !CurrentNode->isCond2D(CT_dYdx_NULL_2D) ) {
-                                            CurrentNode->droYdx[NUM_COMPONENTS]=(rhoY_air_Right - rhoY_air_Left)*dx_1_n_n_1;
-                                        }
-                                        
-                                        if ( !CurrentNode->isCond2D(CT_dYdy_NULL_2D) ) {
-                                            CurrentNode->droYdy[NUM_COMPONENTS]=(rhoY_air_Up - rhoY_air_Down)*dy_1_m_m_1;
-                                        }
-                                        
-                                        if (CurrentNode->isCond2D(CT_WALL_NO_SLIP_2D) || CurrentNode->isCond2D(CT_WALL_LAW_2D) )  {
-                                            CurrentNode->dUdx=(RightNode->U*n1-LeftNode->U*n2)*dx_1_n_n_1;
-                                            CurrentNode->dVdx=(RightNode->V*n1-LeftNode->V*n2)*dx_1_n_n_1;
-
-                                            CurrentNode->dUdy=(UpNode->U*n3-DownNode->U*n4)*dy_1_m_m_1;
-                                            CurrentNode->dVdy=(UpNode->V*n3-DownNode->V*n4)*dy_1_m_m_1;
-
-                                            if(CurrentNode->isTurbulenceCond2D(TCT_k_eps_Model_2D)){
-                                              CurrentNode->dkdx   =(RightNode->S[i2d_k]*n1-LeftNode->S[i2d_k]*n2)*dx_1_n_n_1/CurrentNode->S[i2d_Rho];
-                                              CurrentNode->depsdx =(RightNode->S[i2d_eps]*n1-LeftNode->S[i2d_eps]*n2)*dx_1_n_n_1/CurrentNode->S[i2d_Rho];
-
-                                              CurrentNode->dkdy   =(UpNode->S[i2d_k]*n3-DownNode->S[i2d_k]*n4)*dy_1_m_m_1/CurrentNode->S[i2d_Rho];
-                                              CurrentNode->depsdy =(UpNode->S[i2d_eps]*n3-DownNode->S[i2d_eps]*n4)*dy_1_m_m_1/CurrentNode->S[i2d_Rho];
-                                            } else if (CurrentNode->isTurbulenceCond2D(TCT_Spalart_Allmaras_Model_2D)) {
-                                                       turb_mod_name_index = 3;
-                                                       CurrentNode->dkdx   =(RightNode->S[i2d_k]*n1-LeftNode->S[i2d_k]*n2)*dx_1_n_n_1/CurrentNode->S[i2d_Rho];
-                                                       CurrentNode->dkdy   =(UpNode->S[i2d_k]*n3-DownNode->S[i2d_k]*n4)*dy_1_m_m_1/CurrentNode->S[i2d_Rho];
-                                            }
-                                        } else {
-                                            CurrentNode->dUdx   =(RightNode->U-LeftNode->U)*dx_1_n_n_1;
-                                            CurrentNode->dVdx   =(RightNode->V-LeftNode->V)*dx_1_n_n_1;
-
-                                            CurrentNode->dUdy   =(UpNode->U-DownNode->U)*dy_1_m_m_1;
-                                            CurrentNode->dVdy   =(UpNode->V-DownNode->V)*dy_1_m_m_1;
-                                            if(CurrentNode->isTurbulenceCond2D(TCT_k_eps_Model_2D)){
-                                              CurrentNode->dkdx   =(RightNode->S[i2d_k]-LeftNode->S[i2d_k])*dx_1_n_n_1/CurrentNode->S[i2d_Rho];
-                                              CurrentNode->depsdx =(RightNode->S[i2d_eps]-LeftNode->S[i2d_eps])*dx_1_n_n_1/CurrentNode->S[i2d_Rho];
-
-                                              CurrentNode->dkdy   =(UpNode->S[i2d_k]-DownNode->S[i2d_k])*dy_1_m_m_1/CurrentNode->S[i2d_Rho];
-                                              CurrentNode->depsdy =(UpNode->S[i2d_eps]-DownNode->S[i2d_eps])*dy_1_m_m_1/CurrentNode->S[i2d_Rho];
-                                            } else if (CurrentNode->isTurbulenceCond2D(TCT_Spalart_Allmaras_Model_2D)) {
-                                                       turb_mod_name_index = 3;
-                                                       CurrentNode->dkdx   =(RightNode->S[i2d_k]-LeftNode->S[i2d_k])*dx_1_n_n_1/CurrentNode->S[i2d_Rho];
-                                                       CurrentNode->dkdy   =(UpNode->S[i2d_k]-DownNode->S[i2d_k])*dy_1_m_m_1/CurrentNode->S[i2d_Rho];
-                                            }
-                                        }
-
-                                        CurrentNode->dTdx=(RightNode->Tg-LeftNode->Tg)*dx_1_n_n_1;
-                                        CurrentNode->dTdy=(UpNode->Tg-DownNode->Tg)*dy_1_m_m_1;
-                                    }
-                                    
-                                    if((int)(iter+last_iter) < TurbStartIter) {
-                                       CurrentNode->FillNode2D(0,isTurbulenceReset,SigW,SigF,(TurbulenceExtendedModel)TurbExtModel,delta_bl,ProblemType);
-                                    } else {
-                                       CurrentNode->FillNode2D(1,0,SigW,SigF,(TurbulenceExtendedModel)TurbExtModel,delta_bl,ProblemType);
-                                    }
-
-                                    if( CurrentNode->Tg < 0. ) {
-                                        *f_stream << "\nTg=" << CurrentNode->Tg << " K. p=" << CurrentNode->p <<" Pa dt=" << dt << " sec.\n" << flush;
+                    sp.iter              = (int)(iter+last_iter);
+                    sp.simd              = SIMDKernel;
+                    sp.batch_fill        = isBatchFill;
+                    sp.prop_hint         = 0;
+                    sp.spans             = NodeSpans;
 #ifdef _MPI
-                                        *f_stream << "\nERROR: Computational unstability in UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >(" << (int)(x0/FlowNode2D<FP,NUM_COMPONENTS>::dx) + i <<","<< j << ") \nNode Conditions {\n";
-                                         PrintCond(f_stream,CurrentNode);
-                                        *f_stream  <<"} on iteration " << iter+last_iter<< "...\n";
+                    sp.x_offset          = 0;
+                    sp.DD_max            = DD_max;
+                    sp.rank              = rank;
+                    sp.x0                = x0;
+                    sp.y0                = y0;
 #else
-  #ifdef _OPENMP
-                                        *f_stream << "\nERROR: Computational unstability in local (num_thread="<< omp_get_thread_num() << ") UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >(" << i <<","<< j <<") \nNode Conditions {\n";
-                                        PrintCond(f_stream,CurrentNode);
-                                        *f_stream  <<"} on iteration " << iter+last_iter<< "...\n";
-  #else
-                                        *f_stream << "\nERROR: Computational unstability in UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >(" << i <<","<< j <<") \nNode Conditions {\n";
-                                        PrintCond(f_stream,CurrentNode);
-                                        *f_stream  <<"} on iteration " << iter+last_iter<< "...\n";
-  #endif // _OPENMP
+                    sp.x_offset          = (long)(pJ->GetMatrixPtr()-J->GetMatrixPtr())/MaxY;
+                    sp.res               = ColRes;
 #endif // _MPI
-
-#ifdef _OPENMP
-#pragma omp critical
-                                          {
-                                            char omp_ErrFileName[255];
-                                            snprintf(omp_ErrFileName,255,"tid-%d-%s",omp_get_thread_num(),ErrFileName);  
-                                            DataSnapshot(omp_ErrFileName);
-#endif // _OPENMP
+                    sp.col_offset        = sp.x_offset;
 #ifdef _MPI
-                                          if( rank == 0 ) {
-                                            char mpi_ErrFileName[255];
-                                            snprintf(mpi_ErrFileName,255,"rank-%d-%s",rank,ErrFileName);  
-                                            DataSnapshot(mpi_ErrFileName);
-#else  //  _MPI
-
-                                            DataSnapshot(ErrFileName);
-#endif // _MPI
-#ifdef _OPENMP
-                                           *f_stream << "Computation terminated. Error data saved in file "<< omp_ErrFileName <<" \n" ;
-#else
-#endif //  _OPENMP
-
-#ifdef _MPI
-#ifdef _OPENMP
-                                            if(rank == 0)
-                                              *f_stream << "Computation terminated. Error data saved in file "<< mpi_ErrFileName <<" \n";
-#else  //  _MPI
-
-                                            *f_stream << "Computation terminated. Error data saved in file "<< ErrFileName <<" \n" ;
-#endif //  _OPENMP
+                  // Level lev of deep halo block (HaloDepth > 1) computes own nodes and e halo
+                  // columns/rows at sides with neighbors, halo is exchanged after last level (e=0)
+                  for(int lev=0;lev<n_block;lev++) {
+                    const int    e      = n_block-1-lev;
+                    const int    e_next = (e > 0) ? e-1 : HaloDepth-1;        // halo columns/rows of next level
+                    SweepTile2D* tiles  = (e > 0 && GhostTiles) ? GhostTiles[e]    : Tiles;
+                    const int    n_lt   = (e > 0 && GhostTiles) ? n_ghost_tiles[e] : n_tiles;
+                    const int    n_lty  = (e > 0 && GhostTiles) ? n_gty[e]         : n_ty;
+
+                    sp.StartXLocal       = StartXLocal-min(e,(int)l_Overlap);
+                    sp.MaxXLocal         = MaxXLocal+min(e,(int)r_Overlap);
+                    sp.StartYLocal       = StartYLocal-min(e,(int)d_Overlap);
+                    sp.MaxYLocal         = MaxYLocal+min(e,(int)u_Overlap);
+                    sp.iter              = (int)(iter+last_iter)+lev;
+
+                    if(lev > 0) {
+                       // residuals of last level, dt_min of all levels
+                       FP dt_min_block = DD_max->dt_min;
+
+                       ClearVarPack2D(DD_max);
+                       DD_max->dt_min = dt_min_block;
+                    }
 #endif // _MPI
 
-                                             f_stream->flush();
+                    timeval sweep_start, sweep_stop;
+                    gettimeofday(&sweep_start,NULL);
+#ifndef _MPI
+                    if(n_block > 1) {
+                       if(ii == 0) {
+                          SweepParam2D sp_block = sp;
 
-                                            if ( GasSwapData!=0 ) {
-#ifdef _REMOVE_SWAPFILE_
-                                                CloseSwapFile(GasSwapFileName,
-                                                              GasSwapData,
-                                                              FileSizeGas,
-                                                              fd_g,
-                                                              1);
-#endif // _REMOVE_SWAPFILE_
+                          sp_block.res = TB_ColRes;
 
-                                                useSwapFile = 0; 
-                                            }
-#ifdef _OPENMP
-                                         }
-#endif // _OPENMP
+                          DEEPS2D_TemporalBlock(n_block,&sp_block,&SoA_Kernel,&AoS_Kernel,f_stream);
+                       }
+                    } else
+#endif // _MPI
 #ifdef _MPI
-                                         }
+                    if(isHaloOverlap && e == 0) {
+                       // Stage 2 of edge nodes first, halo exchange is in flight during Stage 2 of interior nodes
+                       SweepParam2D sp_in = sp;
+                       const int    i_in  = StartXLocal+l_Overlap;
+                       const int    j_in  = StartYLocal+d_Overlap;
+
+                       if(n_tiles > 0)
+                          DEEPS2D_TiledSweep(1,Tiles,n_tiles,n_ty,&sp,&SoA_Kernel,&AoS_Kernel,f_stream);
+                       else
+                          DEEPS2D_SubDomainStage(1,pJ,pC,StartXLocal,MaxXLocal,&sp_in,&SoA_Kernel,&AoS_Kernel,f_stream);
+
+                       DEEPS2D_EdgeStage2(pJ,pC,l_Overlap,r_Overlap,d_Overlap,u_Overlap,&sp,
+                                          &SoA_Kernel,&AoS_Kernel,f_stream);
+                       MPI::Prequest::Startall(n_halo_start,HaloRequest);
+                       gettimeofday(&halo_post,NULL);
+
+                       if(n_inner > 0) {
+                          DEEPS2D_TiledSweep(2,InnerTiles,n_inner,n_ity,&sp,&SoA_Kernel,&AoS_Kernel,f_stream);
+                          DEEPS2D_TileResiduals(sp.DD_max,InnerTiles,n_inner);
+                       } else if(n_tiles == 0) {
+                          sp_in             = sp;
+                          sp_in.StartYLocal = j_in;
+                          sp_in.MaxYLocal   = max(j_in,MaxYLocal-(int)u_Overlap);
+                          DEEPS2D_SubDomainStage(2,pJ,pC,i_in,max(i_in,(int)(MaxXLocal-r_Overlap)),&sp_in,
+                                                 &SoA_Kernel,&AoS_Kernel,f_stream);
+                       }
+                    } else
 #endif // _MPI
-
-                                      isRun = 0;
-                                      Abort_OpenHyperFLOW2D();
-                                    }  else {
-                                            FP CFL_min      = min(CFL,CFL_Scenario_Val);
-                                            AAA                 = sqrt(CurrentNode->k*CurrentNode->R*CurrentNode->Tg); 
-                                            dt_min_local        = CFL_min*
-                                                                  min(dx/(AAA+fabs(CurrentNode->U)),dy/(AAA+fabs(CurrentNode->V)));
+                    if(n_tiles > 0) {
 #ifdef _MPI
-                                            DD_max[rank].dt_min = min(DD_max[rank].dt_min, dt_min_local);
-
+                       DEEPS2D_TiledSweep(3,tiles,n_lt,n_lty,&sp,&SoA_Kernel,&AoS_Kernel,f_stream);
+                       DEEPS2D_TileResiduals(sp.DD_max,tiles,n_lt);
 #else
-                                            dt_min[ii]          = min(dt_min[ii],dt_min_local);
+                       if(ii == 0)
+                          DEEPS2D_TiledSweep(3,Tiles,n_tiles,n_ty,&sp,&SoA_Kernel,&AoS_Kernel,f_stream);
 #endif // _MPI
-                                            CalcChemicalReactions(CurrentNode,CRM_ZELDOVICH, (void*)(&chemical_reactions));
-                                    }
-                       } else if (CurrentNode->isCond2D(NT_FC_2D)) {
-                         CurrentNode->FillNode2D(1,0,SigW,SigF,(TurbulenceExtendedModel)TurbExtModel,delta_bl,ProblemType);
+                    } else
+                    if(FieldStorage == FST_SOA) {
+                       sp.bc             = BCMask->GetMask();
+                       sp.cold           = ColdJ->GetMatrixPtr();
+                       if(isFusedSweep) {
+                          SoA_Kernel.Fused(*SoA_Field,&sp,f_stream);
+                       } else {
+                          SoA_Kernel.Stage1(*SoA_Field,&sp);
+                          SoA_Kernel.Stage2(*SoA_Field,&sp,f_stream);
                        }
-                  }
-             }
+                    } else {
+                       FlowFieldAoS2D<FP,NUM_COMPONENTS> AoS_Field(pJ,pC);
+                       sp.bc             = BCMask->GetMask(sp.x_offset*MaxY);
+                       sp.cold           = ColdJ->GetMatrixPtr()+sp.x_offset*MaxY;
+                       sp.x_offset       = 0;
+                       if(isFusedSweep) {
+                          AoS_Kernel.Fused(AoS_Field,&sp,f_stream);
+                       } else {
+                          AoS_Kernel.Stage1(AoS_Field,&sp);
+                          AoS_Kernel.Stage2(AoS_Field,&sp,f_stream);
+                       }
+                    }
+                    gettimeofday(&sweep_stop,NULL);
 #ifdef _MPI
-// --- Halo exchange ---
-                 if(rank < last_rank) {
-// Send Tail
-                 void*  tmp_SendPtr  = (void*)((ulong)pJ->GetMatrixPtr()+
-                                                     (pJ->GetMatrixSize()-2*pJ->GetColSize()));
-                 u_long tmp_SendSize = pJ->GetColSize();
-#ifdef _MPI_NB
-                 HaloExchange[0] = MPI::COMM_WORLD.Isend(tmp_SendPtr,
-                                                         tmp_SendSize,
-                                                         MPI::BYTE,rank+1,
-                                                         tag_MatrixTail);
-#else
-                 MPI::COMM_WORLD.Send(tmp_SendPtr,
-                                      tmp_SendSize,
-                                      MPI::BYTE,rank+1,tag_MatrixTail);
-#endif //_MPI_NB
-
-// Recive Head
-                 void*  tmp_RecvPtr  = (void*)((ulong)pJ->GetMatrixPtr()+
-                                                     (pJ->GetMatrixSize()-
-                                                      pJ->GetColSize()));
-                 u_long tmp_RecvSize = pJ->GetColSize();
-#ifdef _MPI_NB
-                 HaloExchange[1] = MPI::COMM_WORLD.Irecv(tmp_RecvPtr,
-                                                         tmp_RecvSize,
-                                                         MPI::BYTE,rank+1,
-                                                         tag_MatrixHead);
+                    sweep_time += (FP)(sweep_stop.tv_sec-sweep_start.tv_sec)+(FP)(sweep_stop.tv_usec-sweep_start.tv_usec)*1.e-6;
 #else
-                 MPI::COMM_WORLD.Recv(tmp_RecvPtr,
-                                      tmp_RecvSize,
-                                      MPI::BYTE,rank+1,tag_MatrixHead);
-#endif //_MPI_NB
+                    if(SubDomainTime)
+                       SubDomainTime[ii] += (FP)(sweep_stop.tv_sec-sweep_start.tv_sec)+(FP)(sweep_stop.tv_usec-sweep_start.tv_usec)*1.e-6;
+                    // next subdomains of this iteration use dt lowered by this one (isGlobalTimeStep=0)
+                    if(!isGlobalTimeStep && n_block == 1) {
+                       if(n_tiles > 0)
+                          dtmin = min(dtmin,ColumnDtMin2D(ColRes,n_col,n_ty,0,n_col));
+                       else
+                          dtmin = min(dtmin,ColumnDtMin2D(ColRes,n_col,1,(int)sp.col_offset+StartXLocal,(int)sp.col_offset+MaxXLocal));
+                    }
+#endif // _MPI
+#ifdef _MPI
+// --- Halo exchange ---
+// edge columns with left/right neighbors, edge rows with down/up neighbors (after last level of block)
+                 if(e == 0) {
+                    // p, T of monitor points of rank (own nodes are updated), 0 - other points
+                    for(int ii_monitor=0;ii_monitor<n_mon;ii_monitor++) {
+                        FP* mv = MonitorValues2D(DD_max)+2*ii_monitor;
+
+                        mv[0] = mv[1] = 0.;
+                        if(rank == MonitorPointsArray->GetElement(ii_monitor).rank) {
+                           int i_i = (MonitorPointsArray->GetElement(ii_monitor).MonitorXY.GetX() - x0 - FlowNode2D<FP,NUM_COMPONENTS>::dx*0.5)/FlowNode2D<FP,NUM_COMPONENTS>::dx;
+                           int j_j = (MonitorPointsArray->GetElement(ii_monitor).MonitorXY.GetY() - y0)/FlowNode2D<FP,NUM_COMPONENTS>::dy;
+                           mv[0] = pJ->GetValue(i_i,j_j).p;
+                           mv[1] = pJ->GetValue(i_i,j_j).Tg;
+                        }
+                    }
+#if MPI_VERSION >= 3
+                    // residuals, dt_min and monitor values of all ranks (waited before next block)
+                    MPI_Iallreduce(DD_max,DD_all,1,ReduceType,ReduceOp,MPI_COMM_WORLD,&ReduceRequest);
+#endif // MPI_VERSION >= 3
+                    if(!isHaloOverlap) {
+                       MPI::Prequest::Startall(n_halo_start,HaloRequest);
+                       gettimeofday(&halo_post,NULL);
+                    }
 
-             }
-               if(rank > 0) {
-// Recive Tail
-                 void*  tmp_RecvPtr  = (void*)(pJ->GetMatrixPtr());
-                 u_long tmp_RecvSize = pJ->GetColSize();
-#ifdef _MPI_NB
-                 HaloExchange[3] = MPI::COMM_WORLD.Irecv(tmp_RecvPtr,
-                                                         tmp_RecvSize,
-                                                         MPI::BYTE,rank-1,
-                                                         tag_MatrixTail);
-#else
-                 MPI::COMM_WORLD.Recv(tmp_RecvPtr,
-                                      tmp_RecvSize,
-                                      MPI::BYTE,rank-1,tag_MatrixTail);
-#endif //_MPI_NB
-
-//Send  Head
-                 void*  tmp_SendPtr  = (void*)((ulong)pJ->GetMatrixPtr()+
-                                                      pJ->GetColSize());
-                 u_long tmp_SendSize = pJ->GetColSize();
-#ifdef _MPI_NB
-                 HaloExchange[2] = MPI::COMM_WORLD.Isend(tmp_SendPtr,
-                                                         tmp_SendSize,
-                                                         MPI::BYTE,rank-1,tag_MatrixHead);
-#else
-                 MPI::COMM_WORLD.Send(tmp_SendPtr,
-                                      tmp_SendSize,
-                                      MPI::BYTE,rank-1,tag_MatrixHead);
-#endif //_MPI_NB
+                    timeval halo_start, halo_stop;
+                    gettimeofday(&halo_start,NULL);
+                    WaitHaloExchange2D(HaloRequest,n_halo_start,n_halo);
+                    gettimeofday(&halo_stop,NULL);
+                    halo_overlap_time += (FP)(halo_start.tv_sec-halo_post.tv_sec)+(FP)(halo_start.tv_usec-halo_post.tv_usec)*1.e-6;
+                    halo_wait_time    += (FP)(halo_stop.tv_sec-halo_start.tv_sec)+(FP)(halo_stop.tv_usec-halo_start.tv_usec)*1.e-6;
+                    n_halo_wait++;
+                 }
 
-             }
+                 // heat sources of nodes computed by next level
+                 const int hx0 = StartXLocal-min(e_next,(int)l_Overlap), hx1 = MaxXLocal+min(e_next,(int)r_Overlap);
+                 const int hy0 = StartYLocal-min(e_next,(int)d_Overlap), hy1 = MaxYLocal+min(e_next,(int)u_Overlap);
 #endif // _MPI
 
              if(!isAdiabaticWall)
                 CalcHeatOnWallSources(pJ,dx,dy,dt
 #ifdef _MPI
-                                      ,rank,last_rank
+                                      ,hx0,hx1,hy0,hy1
 #else
-                                      ,ii,(int)SubDomainArray->GetNumElements()-1 
+                                      ,StartXLocal,MaxXLocal,sp.StartYLocal,sp.MaxYLocal
 #endif // _MPI
-                                   );
-#ifdef _OPENMP
- for (DD_max_var = 1.,k=0;k<(int)FlowNode2D<FP,NUM_COMPONENTS>::NumEq;k++ ) {
-    DD_max_var = DD[k] = max(DD[k],DD_max(k,ii));
-    if(DD[k] == DD_max(k,ii)) {
-       i_max =  i_c[ii];
-       j_max =  j_c[ii];
-       k_max =  k;
-     }
-  }
- 
- dtmin = min(dt_min[ii],dtmin);
-#endif // _OPENMP
-
+                                      ,NodeSpans,sp.col_offset,ColdJ->GetMatrixPtr()+SubDomainOffset2D(pJ)*MaxY);
 #ifdef _MPI
-      
-#ifdef _MPI_NB
-        if(rank < last_rank) {
-           HaloExchange[0].Wait();
-           HaloExchange[1].Wait();
-        }
-        
-        if(rank > 0) {
-           HaloExchange[3].Wait();
-           HaloExchange[2].Wait();
-        }
-#endif //_MPI_NB
-     
-     
-     if(rank > 0) {
-#ifdef _MPI_NB
-           DD_Exchange[rank-1] = MPI::COMM_WORLD.Isend(&DD_max[rank],sizeof(Var_pack),MPI::BYTE,0,tag_DD);
+             if(!isAdiabaticWall && FieldStorage == FST_SOA)
+                SoA_Field->LoadSrcAdd(hx0,hx1);
+                  }
 #else
-           MPI::COMM_WORLD.Send(&DD_max[rank],sizeof(Var_pack),MPI::BYTE,0,tag_DD);
-#endif //_MPI_NB
+             if(!isAdiabaticWall && FieldStorage == FST_SOA)
+                SoA_Field->LoadSrcAdd(StartXLocal+sp.x_offset,MaxXLocal+sp.x_offset);
+#endif // _MPI
+#ifdef _MPI
+        // received halo -> SoA field (corners of deep halo are gathered with halo columns)
+        for(int g=0;g<(int)HaloDepth;g++) {
+            if(FieldStorage == FST_SOA) {
+               if(r_Overlap)
+                  SoA_Field->GatherColumn(MaxXLocal+g);
+               if(l_Overlap)
+                  SoA_Field->GatherColumn(StartXLocal-1-g);
+               if(u_Overlap)
+                  SoA_Field->GatherRow(MaxYLocal+g,StartXLocal,MaxXLocal);
+               if(d_Overlap)
+                  SoA_Field->GatherRow(StartYLocal-1-g,StartXLocal,MaxXLocal);
+            }
+        }
 
-       } else {
-         for(int ii=1;ii<last_rank+1;ii++) {
-#ifdef _MPI_NB
-           DD_Exchange[last_rank+ii] = MPI::COMM_WORLD.Irecv(&DD_max[ii],sizeof(Var_pack),MPI::BYTE,ii,tag_DD);
+        // residuals, dt_min and values of monitor points of all ranks (one collective)
+#if MPI_VERSION >= 3
+        MPI_Wait(&ReduceRequest,MPI_STATUS_IGNORE);
 #else
-           MPI::COMM_WORLD.Recv(&DD_max[ii],sizeof(Var_pack),MPI::BYTE,ii,tag_DD);
-#endif //_MPI_NB
+        MPI::COMM_WORLD.Allreduce(DD_max,DD_all,1,ReduceType,ReduceOp);
+#endif // MPI_VERSION >= 3
 
-         }
-       }
-
-#ifdef _MPI_NB
-        if(rank > 0) {
-           DD_Exchange[rank-1].Wait();
-        } else {
-          for(int ii=1;ii<last_rank+1;ii++) 
-              DD_Exchange[last_rank+ii].Wait();  
+        if (MonitorPointsArray &&
+            isOutStep(iter,n_block) ) {
+            for(int ii_monitor=0;ii_monitor<n_mon;ii_monitor++) {
+                MonitorPointsArray->GetElement(ii_monitor).p = MonitorValues2D(DD_all)[2*ii_monitor];
+                MonitorPointsArray->GetElement(ii_monitor).T = MonitorValues2D(DD_all)[2*ii_monitor+1];
+            }
         }
-#endif //_MPI_NB
-          
-          if (MonitorPointsArray &&
-              iter/NOutStep*NOutStep == iter ) {
-              for(int ii_monitor=0;ii_monitor<(int)MonitorPointsArray->GetNumElements();ii_monitor++) {
-                  if(rank == MonitorPointsArray->GetElement(ii_monitor).rank) {
-
-                      int i_i = (MonitorPointsArray->GetElement(ii_monitor).MonitorXY.GetX() - x0 - FlowNode2D<FP,NUM_COMPONENTS>::dx*0.5)/FlowNode2D<FP,NUM_COMPONENTS>::dx;
-                      int j_j = MonitorPointsArray->GetElement(ii_monitor).MonitorXY.GetY()/FlowNode2D<FP,NUM_COMPONENTS>::dy;
-                      MonitorPointsArray->GetElement(ii_monitor).p  = pJ->GetValue(i_i,j_j).p;
-                      MonitorPointsArray->GetElement(ii_monitor).T  = pJ->GetValue(i_i,j_j).Tg;
-                  }
 
-                  MPI::COMM_WORLD.Bcast(&MonitorPointsArray->GetElement(ii_monitor).p,
-                                        sizeof(FP),
-                                        MPI::DOUBLE,
-                                        MonitorPointsArray->GetElement(ii_monitor).rank);
+        // residuals of all ranks (the same at all ranks, MonitorCondition is computed by every rank)
+        for (k=0;k<(int)(FlowNode2D<FP,NUM_COMPONENTS>::NumEq);k++ ) {
+             RMS[k]    = DD_all->DD[k].RMS;
+             iRMS[k]   = DD_all->DD[k].iRMS;
+             sumDiv[k] = DD_all->DD[k].sumDiv;
 
-                  MPI::COMM_WORLD.Bcast(&MonitorPointsArray->GetElement(ii_monitor).T,
-                                        sizeof(FP),
-                                        MPI::DOUBLE,
-                                        MonitorPointsArray->GetElement(ii_monitor).rank);
-              }
-        }
-        
-        if(rank == 0) {
-            for(int ii=0,DD_max_var=0.;ii<last_rank+1;ii++) {
-                for (k=0;k<(int)(FlowNode2D<FP,NUM_COMPONENTS>::NumEq);k++ ) {
-                   
-                   DD_max_var = max(DD_max[ii].DD[k].DD,DD_max_var);
-                   
-                   RMS[k]    += DD_max[ii].DD[k].RMS;
-                   iRMS[k]   += DD_max[ii].DD[k].iRMS;
-                   sumDiv[k] += DD_max[ii].DD[k].sumDiv;
-
-                   if(DD_max[ii].DD[k].DD == DD_max_var) {
-                    i_max = DD_max[ii].DD[k].i;
-                    j_max = DD_max[ii].DD[k].j;
-                    k_max = k;
-                  }
-              }
-            }
-            
-            for (k=0;k<(int)(FlowNode2D<FP,NUM_COMPONENTS>::NumEq);k++ ) {
-                
-                
-                if (isAlternateRMS) {
-                    if(RMS[k] > 0.0 && sumDiv[k] > 0) { 
-                       RMS[k] = sqrt(RMS[k]/sumDiv[k]);
-                    }
-                } else {
-                    if(iRMS[k] > 0) {
-                       RMS[k] = sqrt(RMS[k]/iRMS[k]);
-                    }
-                }
-                  
-                  if(MonitorIndex == 0 || MonitorIndex > 4) {
-                     max_RMS = max(RMS[k],max_RMS);
-                     if(max_RMS == RMS[k])
-                        k_max_RMS = k;
-                  } else {
-                     max_RMS = max(RMS[MonitorIndex-1],max_RMS);
-                     if(max_RMS == RMS[MonitorIndex-1])
-                        k_max_RMS = k;
-                  }
+             if (isAlternateRMS) {
+                 if(RMS[k] > 0.0 && sumDiv[k] > 0) { 
+                    RMS[k] = sqrt(RMS[k]/sumDiv[k]);
+                 }
+             } else {
+                 if(iRMS[k] > 0) {
+                    RMS[k] = sqrt(RMS[k]/iRMS[k]);
+                 }
+             }
+
+             if(MonitorIndex == 0 || MonitorIndex > 4) {
+                max_RMS = max(RMS[k],max_RMS);
+                if(max_RMS == RMS[k])
+                   k_max_RMS = k;
+             } else {
+                max_RMS = max(RMS[MonitorIndex-1],max_RMS);
+                if(max_RMS == RMS[MonitorIndex-1])
+                   k_max_RMS = k;
+             }
+        }
 
-                 
-                }
+        if(rank == 0) {
 #else
 #ifdef _OPENMP
 }
@@ -1536,30 +2182,38 @@ void DEEPS2D_Run(ofstream* f_stream
 #pragma omp single
 #endif // _OPENMP
     {
+        // Residuals of last iteration in block,
+        // dt_min over all iterations (conservative CFL)
+        ColumnResidual2D* res = ColRes;
+
+        if(n_block > 1) {
+           res = TB_ColRes + (n_block-1)*n_col;
+           for(int l=0;l<n_block-1;l++)
+               for(int c=0;c<n_col;c++)
+                   res[c].dt_min = min(res[c].dt_min,TB_ColRes[l*n_col+c].dt_min);
+        }
+
+        ReduceColumnResidual2D(res,n_ty*n_col);
+
+        dtmin = min(dtmin,res->dt_min);
+
         for(k=0;k<(int)(FlowNode2D<FP,NUM_COMPONENTS>::NumEq);k++ )     {
-         
-            for(int ii=0;ii<(int)SubDomainArray->GetNumElements();ii++) {
+
              if (isAlternateRMS) {
-                 if(sumDiv(k,ii) > 0.0) {
-                   sum_RMS[k]      += RMS(k,ii);
-                   sum_RMS_Div[k]  +=sumDiv(k,ii);
-                 }
+                 sum_RMS[k]      = res->RMS[k];
+                 sum_RMS_Div[k]  = res->sumDiv[k];
                  if(sum_RMS_Div[k] > 0.0 && sum_RMS[k] > 0.0)
                     sum_RMS[k] = sqrt(sum_RMS[k]/sum_RMS_Div[k]);
                  else
                     sum_RMS[k] = 0.0;
              } else {
-                 if(iRMS(k,ii) > 0) {
-                     sum_RMS[k]  += RMS(k,ii);
-                     sum_iRMS[k] += iRMS(k,ii);
-                 }
+                 sum_RMS[k]  = res->RMS[k];
+                 sum_iRMS[k] = res->iRMS[k];
                  if(sum_iRMS[k] != 0 && sum_RMS[k] > 0.0 )
                     sum_RMS[k] = sqrt(sum_RMS[k]/sum_iRMS[k]);
                  else
                     sum_RMS[k] = 0;
              }
-             
-           }
 
            if( MonitorIndex == 0 || MonitorIndex > 4) {
                max_RMS = max(sum_RMS[k],max_RMS);
@@ -1574,7 +2228,7 @@ void DEEPS2D_Run(ofstream* f_stream
          }
 
         if (MonitorPointsArray &&
-            iter/NOutStep*NOutStep == iter ) {
+            isOutStep(iter,n_block) ) {
             for(int ii_monitor=0;ii_monitor<(int)MonitorPointsArray->GetNumElements();ii_monitor++) {
                     int i_i = (MonitorPointsArray->GetElement(ii_monitor).MonitorXY.GetX()
 #ifdef _MPI
@@ -1599,8 +2253,8 @@ void DEEPS2D_Run(ofstream* f_stream
             }
         }
 #endif // _MPI
-         CurrentTimePart += dt;
-         if ( isVerboseOutput && iter/NOutStep*NOutStep == iter ) {
+         CurrentTimePart += dt*n_block;
+         if ( isVerboseOutput && isOutStep(iter,n_block) ) {
              gettimeofday(&mark1,NULL);
              d_time = (FP)(mark1.tv_sec-mark2.tv_sec)+(FP)(mark1.tv_usec-mark2.tv_usec)*1.e-6; 
 
@@ -1609,7 +2263,7 @@ void DEEPS2D_Run(ofstream* f_stream
              else
                  VCOMP = 0.;
              memcpy(&mark2,&mark1,sizeof(mark1));
-             SaveRMS(pRMS_OutFile,last_iter+iter,
+             SaveRMS(pRMS_OutFile,last_iter+iter+n_block-1,
 #ifdef  _MPI
              RMS);
 #else
@@ -1625,20 +2279,20 @@ void DEEPS2D_Run(ofstream* f_stream
                 k_max_RMS +=turb_mod_name_index;
 
              if(k_max_RMS != -1 && (MonitorIndex == 0 || MonitorIndex == 5))
-             *f_stream << "Step No " << iter+last_iter << " maxRMS["<< RMS_Name[k_max_RMS] << "]="<< (FP)(max_RMS*100.) \
+             *f_stream << "Step No " << iter+last_iter+n_block-1 << " maxRMS["<< RMS_Name[k_max_RMS] << "]="<< (FP)(max_RMS*100.) \
                         <<  " % step_time=" << (FP)d_time << " sec (" << (FP)VCOMP <<" step/sec) dt="<< dt <<"\n" << flush;
              else if(MonitorIndex > 0 &&  MonitorIndex < 5 )
-                 *f_stream << "Step No " << iter+last_iter << " maxRMS["<< RMS_Name[MonitorIndex-1] << "]="<< (FP)(max_RMS*100.) \
+                 *f_stream << "Step No " << iter+last_iter+n_block-1 << " maxRMS["<< RMS_Name[MonitorIndex-1] << "]="<< (FP)(max_RMS*100.) \
                   <<  " % step_time=" << (FP)d_time << " sec (" << (FP)VCOMP <<" step/sec) dt="<< dt <<"\n" << flush;
              else
-             *f_stream << "Step No " << iter+last_iter << " maxRMS["<< k_max_RMS << "]="<< (FP)(max_RMS*100.) \
+             *f_stream << "Step No " << iter+last_iter+n_block-1 << " maxRMS["<< k_max_RMS << "]="<< (FP)(max_RMS*100.) \
                         <<  " % step_time=" << (FP)d_time << " sec (" << (FP)VCOMP <<" step/sec) dt="<< dt <<"\n" << flush;
               f_stream->flush();
              }
 //#ifdef _MPI
         }
 //#endif // _MPI
-     iter++;
+     iter += n_block;
    } while((int)iter < Nstep);
 #ifdef _OPENMP
 #pragma omp single 
@@ -1673,42 +2327,60 @@ void DEEPS2D_Run(ofstream* f_stream
                                     WallNodesUw_2D->GetNumElements()*WallNodesUw_2D->GetElementSize(),
                                     MPI::BYTE,0,tag_WallFrictionVelocity);
        }
-     ParallelRecalc_y_plus(pJ,WallNodes,WallNodesUw_2D,x0);
+     ParallelRecalc_y_plus(pJ,ColdJ,WallNodes,WallNodesUw_2D,x0,y0,NodeSpans);
    }
 #endif // _PARALLEL_RECALC_Y_PLUS_
-     // Collect all subdomain
+     // Sweep time of ranks
+     if(RebalanceStep > 0) {
+        FP* rank_time = (rank == 0) ? new FP[last_rank+1] : NULL;
+
+        MPI::COMM_WORLD.Gather(&sweep_time,1,MPI::DOUBLE,rank_time,1,MPI::DOUBLE,0);
+        if(rank == 0) {
+           for(int ii=0;ii<last_rank+1;ii++)
+               SubDomainTime[ii/ProcGridY] += rank_time[ii];   // time of column of process grid
+           delete[] rank_time;
+        }
+        sweep_time = 0.;
+     }
+     // Halo exchange time without computation (one more exchange, halo is sent to ranks
+     // from J below), computation in flight and wait per iteration (max of ranks).
+     // Exchange is hidden up to time of computation in flight, wait includes load
+     // imbalance of neighbors.
+     if(last_rank > 0) {
+        FP      halo_time[3], max_halo_time[3];
+        timeval halo_start, halo_stop;
+
+        MPI::COMM_WORLD.Barrier();
+        gettimeofday(&halo_start,NULL);
+        MPI::Prequest::Startall(n_halo_start,HaloRequest);
+        WaitHaloExchange2D(HaloRequest,n_halo_start,n_halo);
+        gettimeofday(&halo_stop,NULL);
+
+        halo_time[0] = (FP)(halo_stop.tv_sec-halo_start.tv_sec)+(FP)(halo_stop.tv_usec-halo_start.tv_usec)*1.e-6;
+        halo_time[1] = halo_overlap_time/max(n_halo_wait,1);
+        halo_time[2] = halo_wait_time/max(n_halo_wait,1);
+        MPI::COMM_WORLD.Reduce(halo_time,max_halo_time,3,MPI::DOUBLE,MPI::MAX,0);
+        if(rank == 0)
+           *f_stream << "Halo exchange: " << max_halo_time[0]*1.e6 << " us per "
+                     << (HaloDepth > 1 ? "exchange, " : "iteration, ")
+                     << min(max_halo_time[0],max_halo_time[1])*1.e6 << " us hidden ("
+                     << 100.*min(max_halo_time[0],max_halo_time[1])/max(max_halo_time[0],(FP)1.e-9) << "%), wait "
+                     << max_halo_time[2]*1.e6 << " us\n" << flush;
+        halo_wait_time = halo_overlap_time = 0.;
+        n_halo_wait    = 0;
+     }
+     // Collect all subdomain (own nodes of ranks -> J)
         if(rank>0) {
-            
-            void*  tmp_SendPtr=(void*)((u_long)(pJ->GetMatrixPtr())+
-                                                pJ->GetColSize()*l_Overlap);
-            u_long tmp_SendSize=pJ->GetMatrixSize()-
-                                pJ->GetColSize()*(l_Overlap);
-            
-            
-#ifdef _IMPI_
-        LongMatrixSend(0, tmp_SendPtr, tmp_SendSize);  // Low Mem Send subdomain
-#else
-        MPI::COMM_WORLD.Send(tmp_SendPtr,
-                             tmp_SendSize,
-                             MPI::BYTE,0,tag_Matrix); 
-#endif // _IMPI_
-        
+            SendBlock2D(0,&pJ->GetValue(StartXLocal,StartYLocal),
+                        MaxXLocal-StartXLocal,MaxYLocal-StartYLocal,pJ->GetY(),
+                        sizeof(FlowNode2D<FP,NUM_COMPONENTS>),tag_Matrix);
         } else {
-        void*  tmp_RecvPtr;
-        u_long tmp_RecvSize;
         for(int ii=1;ii<last_rank+1;ii++) {
-           tmp_RecvPtr=(void*)((u_long)(ArraySubDomain->GetElement(ii)->GetMatrixPtr())+
-                                        ArraySubDomain->GetElement(ii)->GetColSize()*(r_Overlap+
-                                                                                      l_Overlap));
-           tmp_RecvSize=ArraySubDomain->GetElement(ii)->GetMatrixSize()-
-                        ArraySubDomain->GetElement(ii)->GetColSize()*(r_Overlap-l_Overlap);
-#ifdef _IMPI_
-           LongMatrixRecv(ii, tmp_RecvPtr, tmp_RecvSize);  // Low Mem Send subdomain
-#else
-           MPI::COMM_WORLD.Recv(tmp_RecvPtr,
-                                tmp_RecvSize,
-                                MPI::BYTE,ii,tag_Matrix); 
-#endif // _IMPI_
+           Block2D b;
+           GetBlock2D(ii,&b);
+           RecvBlock2D(ii,&J->GetValue(b.i_start,b.j_start),
+                       b.i_end-b.i_start,b.j_end-b.j_start,MaxY,
+                       sizeof(FlowNode2D<FP,NUM_COMPONENTS>),tag_Matrix);
            }
         
         }
@@ -1722,38 +2394,24 @@ void DEEPS2D_Run(ofstream* f_stream
                  }
 #ifndef _PARALLEL_RECALC_Y_PLUS_
                 *f_stream << "Recalc y+...";
-                 Recalc_y_plus(J,WallNodes);
+                 Recalc_y_plus(J,ColdJ,WallNodes);
 #endif // _IMPI_
             }
                 
     
-// Get Data back
+// Get Data back (J -> local field with halo of ranks)
     if(rank>0) {
-        void*  tmp_RecvPtr=(void*)((u_long)(pJ->GetMatrixPtr())+pJ->GetColSize()*l_Overlap);
-        u_long tmp_RecvSize=pJ->GetMatrixSize()-pJ->GetColSize()*(l_Overlap);
-
-#ifdef _IMPI_
-        LongMatrixRecv(0, tmp_RecvPtr, tmp_RecvSize);  // Low Mem Send subdomain
-#else
-        MPI::COMM_WORLD.Recv(tmp_RecvPtr,
-                             tmp_RecvSize,
-                             MPI::BYTE,0,tag_Matrix);
-#endif //_IMPI_
+        RecvBlock2D(0,pJ->GetMatrixPtr(),pJ->GetX(),pJ->GetY(),pJ->GetY(),
+                    sizeof(FlowNode2D<FP,NUM_COMPONENTS>),tag_Matrix);
     } else {
-      void*  tmp_SendPtr;
-      u_long tmp_SendSize;
       for(int ii=1;ii<last_rank+1;ii++) {
-          tmp_SendPtr=(void*)((u_long)(ArraySubDomain->GetElement(ii)->GetMatrixPtr())+
-          ArraySubDomain->GetElement(ii)->GetColSize()*(r_Overlap+l_Overlap));
-          tmp_SendSize=ArraySubDomain->GetElement(ii)->GetMatrixSize()-
-          ArraySubDomain->GetElement(ii)->GetColSize()*(r_Overlap-l_Overlap);
-#ifdef _IMPI_
-          LongMatrixSend(ii, tmp_SendPtr, tmp_SendSize);  // Low Mem Send subdomain
-#else
-          MPI::COMM_WORLD.Send(tmp_SendPtr,
-                               tmp_SendSize,
-                               MPI::BYTE,ii,tag_Matrix);
-#endif //_IMPI_ 
+          Block2D b;
+          GetBlock2D(ii,&b);
+          const int l_ov = HaloDepth*(b.left  != MPI::PROC_NULL), r_ov = HaloDepth*(b.right != MPI::PROC_NULL);
+          const int d_ov = HaloDepth*(b.down  != MPI::PROC_NULL), u_ov = HaloDepth*(b.up    != MPI::PROC_NULL);
+          SendBlock2D(ii,&J->GetValue(b.i_start-l_ov,b.j_start-d_ov),
+                      b.i_end-b.i_start+l_ov+r_ov,b.j_end-b.j_start+d_ov+u_ov,MaxY,
+                      sizeof(FlowNode2D<FP,NUM_COMPONENTS>),tag_Matrix);
       }
     }
 
@@ -1768,42 +2426,45 @@ void DEEPS2D_Run(ofstream* f_stream
         }
         
         gettimeofday(&stop,NULL);
+        Snapshot2D* snap = GetSnapshot2D(GlobalTime); // NULL - synchronous output
 #ifdef  _GNUPLOT_
         *f_stream << "\nSave current results in file " << OutFileName << "...\n" << flush; 
-        DataSnapshot(OutFileName,WM_REWRITE);
+        if(snap)
+           snap->out |= SNAP_GNUPLOT;
+        else
+           DataSnapshot(OutFileName,WM_REWRITE);
 #endif // _GNUPLOT_
         if ( (I/NSaveStep)*NSaveStep == I ) {
 #ifdef  _TECPLOT_
              *f_stream << "Add current results to transient solution file " << TecPlotFileName << "...\n" << flush; 
-             DataSnapshot(TecPlotFileName,WM_APPEND); 
+             if(snap)
+                snap->out |= SNAP_TECPLOT;
+             else
+                DataSnapshot(TecPlotFileName,WM_APPEND); 
 #endif // _TECPLOT_
          }
          I++;
          d_time = (FP)(stop.tv_sec-start.tv_sec)+(FP)(stop.tv_usec-start.tv_usec)*1.e-6; 
          *f_stream << "HyperFLOW/DEEPS computation cycle time=" << (FP)d_time << " sec ( average  speed " << (FP)(Nstep/d_time) <<" step/sec).       \n" << flush;
          f_stream->flush();
+         if(RebalanceStep > 0 && I % RebalanceStep == 0)
+            RebalanceSubDomains(f_stream,SubDomainTime);
          last_iter  += iter;
          iter = 0;
          GlobalTime += CurrentTimePart;
          CurrentTimePart  = 0.;
+         ColdJ->GetValue(0,0).time = GlobalTime; // saved in cold swap file with gas area (see below)
 
-         if(isOutHeatFluxX) {
-          char HeatFluxXFileName[255];
-          snprintf(HeatFluxXFileName,255,"HeatFlux-X-%s",OutFileName);
-          CutFile(HeatFluxXFileName);
-          pHeatFlux_OutFile = OpenData(HeatFluxXFileName);
-
-          SaveXHeatFlux2D(pHeatFlux_OutFile,J,Flow2DList->GetElement(Cp_Flow_index-1),Ts0,y_max,y_min);
-          pHeatFlux_OutFile->close();
+         if(isOutHeatFluxX && snap) {
+          snap->out |= SNAP_HEAT_FLUX_X;
+         } else if(isOutHeatFluxX) {
+          SaveHeatFlux2D('X',J);
          }
 
-         if(isOutHeatFluxY) {
-          char HeatFluxYFileName[255];
-          snprintf(HeatFluxYFileName,255,"HeatFlux-Y-%s",OutFileName);
-          CutFile(HeatFluxYFileName);
-          pHeatFlux_OutFile = OpenData(HeatFluxYFileName);
-          SaveYHeatFlux2D(pHeatFlux_OutFile,J,Ts0);
-          pHeatFlux_OutFile->close();
+         if(isOutHeatFluxY && snap) {
+          snap->out |= SNAP_HEAT_FLUX_Y;
+         } else if(isOutHeatFluxY) {
+          SaveHeatFlux2D('Y',J);
          }
 
          if(is_Cx_calc) { // For Airfoils only
@@ -1819,34 +2480,22 @@ void DEEPS2D_Run(ofstream* f_stream
                        if(isVerboseOutput)
                         *f_stream << "\nSync swap file for gas..." << flush;
 #ifdef  _NO_MMAP_
-#ifdef _WRITE_LARGE_FILE_
-//#warning "Sync file >2Gb..."
-                        lseek(fd_g,0,SEEK_SET);
-                        ssize_t max_write = 1024L*1024L*1024L;
-                        ssize_t one_write = 0L;
-                        ssize_t len  = 0L;
-                        off_t  off = 0L;
-                        char* TmpPtr=(char*)J->GetMatrixPtr();
-                        if(J->GetMatrixSize() > max_write) {
-                           for(off = 0L,one_write = max_write; len < J->GetMatrixSize(); off += max_write) {
-                           len += pwrite64(fd_g,TmpPtr+off,one_write,off);
-                           if(J->GetMatrixSize() - len < max_write)
-                              one_write = J->GetMatrixSize() - len;
-                            }
-                        if(len != J->GetMatrixSize())
-                           *f_stream << "Error: len(" << len << ") != FileSize(" << J->GetMatrixSize() << ") " << endl << flush;
+                        if(snap) {
+                           memcpy((void*)snap->pCold->GetMatrixPtr(),(void*)ColdJ->GetMatrixPtr(),ColdJ->GetMatrixSize());
+                           snap->out |= SNAP_SWAP;
                         } else {
-                           len = pwrite64(fd_g,J->GetMatrixPtr(),J->GetMatrixSize(),0L);
+                           WriteSwapFile2D(fd_g,(char*)J->GetMatrixPtr(),J->GetMatrixSize(),f_stream);
+                           if(ColdSwapData)
+                              WriteSwapFile2D(fd_c,(char*)ColdJ->GetMatrixPtr(),ColdJ->GetMatrixSize(),f_stream);
                         }
-#else
-                        lseek(fd_g,0,SEEK_SET);
-                        write(fd_g,J->GetMatrixPtr(),J->GetMatrixSize());
-#endif // _WRITE_LARGE_FILE_
 #else
                         msync(J->GetMatrixPtr(),J->GetMatrixSize(),MS_SYNC);
+                        if(ColdSwapData)
+                           msync(ColdJ->GetMatrixPtr(),ColdJ->GetMatrixSize(),MS_SYNC);
 #endif //  _GPFS
                         *f_stream << "OK" << endl;
                      }
+                     PostSnapshot2D(snap);               // writer saves snapshot during next cycle
 #ifdef _MPI
      }
      MPI::COMM_WORLD.Bcast(&GlobalTime,1,MPI::DOUBLE,0);
@@ -1859,9 +2508,6 @@ void DEEPS2D_Run(ofstream* f_stream
 #ifdef _PROFILE_
  Abort_OpenHyperFLOW2D();
 #endif // _PROFILE_
-#ifdef _MPI
- MPI::COMM_WORLD.Bcast(&isRun,1,MPI::INT,0);
-#endif //  _MPI
 #ifdef _OPENMP
           }
 //#pragma omp barrier
@@ -1878,9 +2524,6 @@ void DEEPS2D_Run(ofstream* f_stream
               else
                 MonitorCondition = 0;
            }
-#ifdef _MPI
- MPI::COMM_WORLD.Bcast(&MonitorCondition,1,MPI::INT,0);
-#endif //  _MPI
 }while( MonitorCondition );
 //---   Save  results ---
 #ifdef _MPI
@@ -1890,6 +2533,7 @@ if (rank == 0) {
 #ifdef _DEBUG_0
                 ___try {
 #endif  // _DEBUG_0
+                    StopSnapshotWriter2D();     // save queued snapshots first
 #ifdef  _GNUPLOT_
                     DataSnapshot(OutFileName,WM_REWRITE);
 #endif //  _GNUPLOT_
@@ -2014,6 +2658,48 @@ if (rank == 0) {
             __end_except;
 #endif // _DEBUG_0
 
+           if(SoA_Field) {
+              delete SoA_Field;
+              SoA_Field = NULL;
+           }
+           if(BCMask) {
+              delete BCMask;
+              BCMask = NULL;
+           }
+           if(NodeSpans) {
+              delete NodeSpans;
+              NodeSpans = NULL;
+           }
+#ifndef _MPI
+           DeleteColumnResidual2D(ColRes);
+           DeleteColumnResidual2D(TB_ColRes);
+#else
+           if(TileDD)
+              delete[] TileDD;
+           if(InnerTiles)
+              delete[] InnerTiles;
+           if(GhostTiles) {
+              for(int e=1;e<HaloDepth;e++)
+                  delete[] GhostTiles[e];
+              delete[] GhostTiles;
+              delete[] n_ghost_tiles;
+              delete[] n_gty;
+           }
+           for(int ii=0;ii<n_halo;ii++)
+               HaloRequest[ii].Free();
+           if(l_Overlap || r_Overlap)
+              ColType.Free();
+           if(d_Overlap || u_Overlap)
+              RowType.Free();
+           HaloNodeType.Free();
+           ReduceType.Free();
+           ReduceOp.Free();
+           delete[] (char*)DD_max;
+#endif // _MPI
+           if(Tiles)
+              delete[] Tiles;
+           if(SubDomainTime)
+              delete[] SubDomainTime;
 #ifdef _MPI
            if(rank == 0)
 #endif // _MPI
@@ -2141,15 +2827,15 @@ ScanArea(ofstream* f_str,ComputationalMatrix2D* pJ ,int isPrint) {
     }
 
 #ifdef _MPI
-num_threads = MPI::COMM_WORLD.Get_size();
-#endif // _MPI
-
+num_threads = ProcGridX;                            // one subdomain per column of process grid (OpenMP threads share it)
+#else
 #ifdef _OPENMP
 #pragma omp parallel
 {
  num_threads = omp_get_num_threads(); 
 }
 #endif // _OPENMP
+#endif // _MPI
 active_nodes_per_SubDomain = num_active_nodes/num_threads; 
 if ( isPrint )
         *f_str << "Found " << pWallNodes->GetNumElements() <<" wall nodes from " << num_active_nodes << " gas filled nodes (" << num_threads <<" threads, "<< active_nodes_per_SubDomain <<" active nodes per thread).\n" << flush;
@@ -2240,12 +2926,375 @@ f_str->flush();
 return SubDomain;
 }
 
-void SetInitBoundaryLayer(ComputationalMatrix2D* pJ, FP delta) {
+// Cost of columns 0...MaxX-1 from measured time sd_time[k] of subdomains sd[k]
+// (time of subdomain is spread over its own columns by number of gas nodes)
+void SetColumnCost(ComputationalMatrix2D* pJ, UArray< XY<int> >* sd, FP* sd_time, FP* col_cost) {
+    for (int i=0;i<(int)MaxX;i++ )
+        col_cost[i] = 0.;
+
+    for (int k=0;k<(int)sd->GetNumElements();k++ ) {
+        const int i_start = (k == 0) ? 0 : sd->GetElementPtr(k)->GetX()+1;
+        const int i_end   = min(sd->GetElementPtr(k)->GetY(),(int)MaxX);
+        long      num_nodes = 0;
+
+        for (int i=i_start;i<i_end;i++ ) {
+            col_cost[i] = 1.;                                        // empty column cost
+            for (int j=0;j<(int)MaxY;j++ )
+                if(!pJ->GetValue(i,j).isCond2D(CT_SOLID_2D))
+                   col_cost[i] += 1.;
+            num_nodes += (long)col_cost[i];
+        }
+
+        for (int i=i_start;i<i_end;i++ )
+            col_cost[i] *= sd_time[k]/num_nodes;
+    }
+}
+
+// Split columns 0...n_col-1 (n_col=0 - MaxX) to n_parts subdomains (ScanArea() format)
+// with equal cost, NULL if cost is unknown or columns are not enough
+UArray< XY<int> >* SplitSubDomains(FP* col_cost, int n_parts, int n_col) {
+    UArray< XY<int> >* SubDomain;
+    XY<int> ijsm;
+    FP      sum_cost = 0., part_cost = 0.;
+    int     k = 1;
+
+    if(n_col == 0)
+       n_col = (int)MaxX;
+
+    for (int i=0;i<n_col;i++ )
+        sum_cost += col_cost[i];
+
+    if(sum_cost <= 0.)
+       return NULL;
+
+    SubDomain = new UArray< XY<int> >();
+    ijsm.SetX(0);
+
+    for (int i=0;i<n_col-1 && k < n_parts;i++ ) {
+        part_cost += col_cost[i];
+        if(part_cost >= sum_cost*k/n_parts && (k == 1 || i > ijsm.GetX())) {  // one own column at least
+           ijsm.SetY(i+1);
+           SubDomain->AddElement(&ijsm);
+           ijsm.SetX(i);
+           k++;
+        }
+    }
+
+    ijsm.SetY(n_col);
+    SubDomain->AddElement(&ijsm);
+
+    if((int)SubDomain->GetNumElements() != n_parts) {
+        delete SubDomain;
+        return NULL;
+    }
+    return SubDomain;
+}
+
+int SaveColumnCost(char* FileName, FP* col_cost) {
+    ofstream CostFile(FileName);
+
+    if(!CostFile)
+       return 0;
+
+    CostFile << MaxX << "\n";
+    for (int i=0;i<(int)MaxX;i++ )
+        CostFile << col_cost[i] << "\n";
+    return CostFile.good();
+}
+
+// Cost of columns saved by SaveColumnCost(), NULL if file is absent or for other mesh
+FP* LoadColumnCost(char* FileName) {
+    ifstream     CostFile(FileName);
+    unsigned int n = 0;
+    FP*          col_cost;
+
+    if(!CostFile || !(CostFile >> n) || n != MaxX)
+       return NULL;
+
+    col_cost = new FP[MaxX];
+    for (int i=0;i<(int)MaxX;i++ )
+        if(!(CostFile >> col_cost[i])) {
+           delete[] col_cost;
+           return NULL;
+        }
+    return col_cost;
+}
+
+#ifdef _MPI
+// Process grid ProcGridX x ProcGridY of all ranks (ProcGridY=0 - grid with minimal
+// halo of rank and 3 columns/rows per rank at least), rank = px*ProcGridY+py
+void InitProcGrid2D(InputData* _data, int rank) {
+    const int n_ranks    = MPI::COMM_WORLD.Get_size();
+    int       dims[2];
+    bool      periods[2] = {false,false};
+
+    if(ProcGridY == 0) {
+       FP min_halo = -1.;
+
+       ProcGridY = 1;
+       for (int py=1;py<=n_ranks;py++ ) {
+           const int px = n_ranks/py;
+           FP        halo;
+
+           if(px*py != n_ranks || (int)MaxX < 3*px || (int)MaxY < 3*py)
+              continue;
+           halo = (px > 1 ? (FP)MaxY/py : 0.) + (py > 1 ? (FP)MaxX/px : 0.);
+           if(min_halo < 0. || halo < min_halo) {
+              min_halo  = halo;
+              ProcGridY = py;
+           }
+       }
+    }
+
+    if(n_ranks % ProcGridY != 0) {
+       if(rank == 0)
+          *(_data->GetMessageStream()) << "ERROR: ProcGridY=" << ProcGridY << " isn't divisor of number of ranks ("
+                                       << n_ranks << ").\n" << flush;
+       Abort_OpenHyperFLOW2D();
+    }
+
+    ProcGridX  = n_ranks/ProcGridY;
+    dims[0]    = ProcGridX;
+    dims[1]    = ProcGridY;
+    ProcGrid2D = MPI::COMM_WORLD.Create_cart(2,dims,periods,false);
+
+    if(rank == 0)
+       *(_data->GetMessageStream()) << "Process grid: " << ProcGridX << "x" << ProcGridY << "\n" << flush;
+}
+
+// Rows of process grid with equal number of gas nodes (rank 0, after ScanArea())
+UArray< XY<int> >* SplitRows2D(ComputationalMatrix2D* pJ) {
+    UArray< XY<int> >* sd;
+    FP*                row_cost = new FP[MaxY];
+
+    for (int j=0;j<(int)MaxY;j++ ) {
+        row_cost[j] = 1.;                                            // empty row cost
+        for (int i=0;i<(int)MaxX;i++ )
+            if(!pJ->GetValue(i,j).isCond2D(CT_SOLID_2D))
+               row_cost[j] += 1.;
+    }
+    sd = SplitSubDomains(row_cost,ProcGridY,(int)MaxY);
+    delete[] row_cost;
+    return sd;
+}
+
+// GlobalSubDomain, GlobalSubDomainY of rank 0 -> all ranks, HaloDepth is limited by size of blocks
+void BcastSubDomains2D(int rank) {
+    int n[2];
+
+    if(rank == 0) {
+       n[0] = GlobalSubDomain->GetNumElements();
+       n[1] = GlobalSubDomainY->GetNumElements();
+    }
+    MPI::COMM_WORLD.Bcast(n,2,MPI::INT,0);
+    if(rank > 0) {
+       GlobalSubDomain  = new UArray< XY<int> >(n[0],-1);
+       GlobalSubDomainY = new UArray< XY<int> >(n[1],-1);
+    }
+    MPI::COMM_WORLD.Bcast(GlobalSubDomain->GetArrayPtr(),n[0]*sizeof(XY<int>),MPI::BYTE,0);
+    MPI::COMM_WORLD.Bcast(GlobalSubDomainY->GetArrayPtr(),n[1]*sizeof(XY<int>),MPI::BYTE,0);
+
+    // halo of rank is taken from own columns/rows of one neighbor
+    for(int c=0;c<n[0] && n[0] > 1;c++)
+        HaloDepth = min(HaloDepth,GlobalSubDomain->GetElementPtr(c)->GetY()-GlobalSubDomain->GetElementPtr(c)->GetX()-(c > 0));
+    for(int c=0;c<n[1] && n[1] > 1;c++)
+        HaloDepth = min(HaloDepth,GlobalSubDomainY->GetElementPtr(c)->GetY()-GlobalSubDomainY->GetElementPtr(c)->GetX()-(c > 0));
+    HaloDepth = max(HaloDepth,1);
+}
+
+// Block of rank r (see BcastSubDomains2D())
+void GetBlock2D(int r, Block2D* b) {
+    int c[2], nc[2];
+
+    ProcGrid2D.Get_coords(r,2,c);
+
+    b->i_start = GlobalSubDomain->GetElementPtr(c[0])->GetX() + (c[0] > 0);
+    b->i_end   = GlobalSubDomain->GetElementPtr(c[0])->GetY();
+    b->j_start = GlobalSubDomainY->GetElementPtr(c[1])->GetX() + (c[1] > 0);
+    b->j_end   = GlobalSubDomainY->GetElementPtr(c[1])->GetY();
+
+    nc[0] = c[0]-1; nc[1] = c[1];
+    b->left  = (c[0] > 0)           ? ProcGrid2D.Get_cart_rank(nc) : MPI::PROC_NULL;
+    nc[0] = c[0]+1;
+    b->right = (c[0] < ProcGridX-1) ? ProcGrid2D.Get_cart_rank(nc) : MPI::PROC_NULL;
+    nc[0] = c[0];   nc[1] = c[1]-1;
+    b->down  = (c[1] > 0)           ? ProcGrid2D.Get_cart_rank(nc) : MPI::PROC_NULL;
+    nc[1] = c[1]+1;
+    b->up    = (c[1] < ProcGridY-1) ? ProcGrid2D.Get_cart_rank(nc) : MPI::PROC_NULL;
+}
+#else
+// Subdomain ii is computed by thread ii % num_threads (see ScanArea())
+static int GetNumThreads2D() {
+    int num_threads = 1;
+#ifdef _OPENMP
+#pragma omp parallel
+{
+#pragma omp master
+    num_threads = omp_get_num_threads();
+}
+#endif // _OPENMP
+    return num_threads;
+}
+
+// Pin OpenMP thread t to t-th CPU of process affinity mask
+// (if isThreadPinning and OMP_PROC_BIND isn't set) and print CPU and NUMA node of threads
+void PinThreads2D(ofstream* f_stream) {
+    const int num_threads = GetNumThreads2D();
+    const int max_cpu     = 4096;
+    int*      cpu_list    = new int[max_cpu];
+    int*      cpu         = new int[num_threads];
+    int*      node        = new int[num_threads];
+    int       num_cpu     = GetCPUList2D(cpu_list,max_cpu);
+    int       isPin       = isThreadPinning && num_cpu > 0 && getenv("OMP_PROC_BIND") == NULL;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif // _OPENMP
+    {
+#ifdef _OPENMP
+     const int t = omp_get_thread_num();
+#else
+     const int t = 0;
+#endif // _OPENMP
+     if(isPin)
+        PinThread2D(cpu_list[t % num_cpu]);
+     node[t] = GetThreadNode2D(&cpu[t]);
+    }
+
+    *f_stream << "Threads" << (isPin ? " (pinned)" : "") << ":";
+    for(int t=0;t<num_threads;t++)
+        *f_stream << " " << t << "->CPU" << cpu[t] << "/node" << node[t];
+    *f_stream << "\n" << flush;
+
+    delete[] cpu_list;
+    delete[] cpu;
+    delete[] node;
+}
+
+// (Re)create views of J and core matrices of subdomains sd.
+// Core matrix of subdomain is allocated (first touched) by its thread,
+// pages of own columns of J are moved to NUMA node of this thread (if isNUMAPlacement).
+void SetSubDomains2D(UArray< XY<int> >* sd) {
+    const int n_s         = (int)sd->GetNumElements();
+    const int num_threads = GetNumThreads2D();
+    UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >**     TmpSubDomain     = new UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >*[n_s];
+    UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >** TmpCoreSubDomain = new UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >*[n_s];
+
+    for (int i=0;i<(int)SubDomainArray->GetNumElements();i++ ) {
+        delete SubDomainArray->GetElement(i);
+        delete CoreSubDomainArray->GetElement(i);
+    }
+    SubDomainArray->CleanArray();
+    CoreSubDomainArray->CleanArray();
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(num_threads)
+#endif // _OPENMP
+    {
+#ifdef _OPENMP
+     const int t = omp_get_thread_num();
+#else
+     const int t = 0;
+#endif // _OPENMP
+     for (int i=t;i<n_s;i+=num_threads) {
+         int SubStartIndex = sd->GetElementPtr(i)->GetX();
+         int SubMaxX       = sd->GetElementPtr(i)->GetY();
+         int Overlap       = (i == n_s-1) ? 0 : 1;
+         int l_Overlap     = (i == 0) ? 0 : 1;
+         FlowNode2D<FP,NUM_COMPONENTS>* TmpMatrixPtr=(FlowNode2D<FP,NUM_COMPONENTS>*)((ulong)J->GetMatrixPtr()+(ulong)(sizeof(FlowNode2D<FP,NUM_COMPONENTS>)*SubStartIndex*MaxY));
+         TmpSubDomain[i]     = new UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >(TmpMatrixPtr,(SubMaxX-SubStartIndex)+Overlap,MaxY);
+         TmpCoreSubDomain[i] = new UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >((SubMaxX-SubStartIndex)+Overlap,MaxY);
+         if(isNUMAPlacement)
+            MovePages2D(TmpMatrixPtr+l_Overlap*MaxY,
+                        sizeof(FlowNode2D<FP,NUM_COMPONENTS>)*(SubMaxX-SubStartIndex-l_Overlap)*MaxY,
+                        GetThreadNode2D());
+     }
+    }
+
+    for (int i=0;i<n_s;i++) {
+         SubDomainArray->AddElement(&TmpSubDomain[i]);
+         CoreSubDomainArray->AddElement(&TmpCoreSubDomain[i]);
+    }
+
+    delete[] TmpSubDomain;
+    delete[] TmpCoreSubDomain;
+}
+
+// NUMA node of thread and of field/core memory of subdomains
+void PrintPlacement2D(ofstream* f_stream) {
+    const int n_s         = (int)SubDomainArray->GetNumElements();
+    const int num_threads = GetNumThreads2D();
+    int*      node        = new int[num_threads];
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(num_threads)
+#endif // _OPENMP
+    {
+#ifdef _OPENMP
+     node[omp_get_thread_num()] = GetThreadNode2D();
+#else
+     node[0] = GetThreadNode2D();
+#endif // _OPENMP
+    }
+
+    for (int i=0;i<n_s;i++) {
+        UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >*     pJ = SubDomainArray->GetElement(i);
+        UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >* pC = CoreSubDomainArray->GetElement(i);
+        *f_stream << "SubDomain(" << i << "): thread " << i % num_threads << " node " << node[i % num_threads]
+                  << ", field pages on node " << GetPageNode2D(pJ->GetMatrixPtr()+pJ->GetMatrixSize()/sizeof(FlowNode2D<FP,NUM_COMPONENTS>)/2)
+                  << ", core pages on node " << GetPageNode2D(pC->GetMatrixPtr()+pC->GetMatrixSize()/sizeof(FlowNodeCore2D<FP,NUM_COMPONENTS>)/2)
+                  << "\n";
+    }
+    f_stream->flush();
+    delete[] node;
+}
+#endif // _MPI
+
+// Rebalance subdomains (MPI - ranks) by sweep time sd_time[] measured since last call.
+// OpenMP - new SubDomainArray, MPI - only decomposition for next start (ranks keep their
+// blocks, see 'CostStep' and InitDEEPS2D()), cost of columns is saved in CostFileName in both cases.
+void RebalanceSubDomains(ofstream* f_stream, FP* sd_time) {
+    const int          n_s      = (int)GlobalSubDomain->GetNumElements();
+    FP*                col_cost = new FP[MaxX];
+    UArray< XY<int> >* sd;
+
+    SetColumnCost(J,GlobalSubDomain,sd_time,col_cost);
+    sd = SplitSubDomains(col_cost,n_s);
+
+    if(sd && !SaveColumnCost(CostFileName,col_cost))
+       *f_stream << "\nWARNING: Can't save cost of columns in file " << CostFileName << ".\n" << flush;
+
+    delete[] col_cost;
+
+    if(sd == NULL)
+       return;
+
+#ifdef _MPI
+    *f_stream << "SubDomain decomposition by measured time (for next start):\n";
+#else
+    *f_stream << "SubDomain decomposition by measured time:\n";
+#endif // _MPI
+    for (int k=0;k<n_s;k++ ) {
+        *f_stream << "SubDomain[" << k << "]->["<< sd->GetElementPtr(k)->GetX() <<","<< sd->GetElementPtr(k)->GetY() <<"]"
+                  << " (time=" << sd_time[k] << " sec)\n";
+        sd_time[k] = 0.;
+    }
+    f_stream->flush();
+#ifdef _MPI
+    delete sd;
+#else
+    delete GlobalSubDomain;
+    GlobalSubDomain = sd;
+    SetSubDomains2D(GlobalSubDomain);
+#endif // _MPI
+}
+
+void SetInitBoundaryLayer(ComputationalMatrix2D* pJ, ColdMatrix2D* pCold, FP delta) {
     for (int i=0;i<(int)pJ->GetX();i++ ) {
            for (int j=0;j<(int)pJ->GetY();j++ ) {
                   if (pJ->GetValue(i,j).isCond2D(CT_NODE_IS_SET_2D) &&
                       !pJ->GetValue(i,j).isCond2D(CT_SOLID_2D) &&
-                       pJ->GetValue(i,j).time == 0. &&
+                       pCold->GetValue(i,j).time == 0. &&
                        delta > 0) {
                        if(pJ->GetValue(i,j).l_min <= delta)
                           pJ->GetValue(i,j).S[i2d_RhoU] = pJ->GetValue(i,j).S[i2d_RhoU] * pJ->GetValue(i,j).l_min/delta;
@@ -2256,6 +3305,17 @@ void SetInitBoundaryLayer(ComputationalMatrix2D* pJ, FP delta) {
     }
 }
 
+// Create cold side-table for computation area pJ (in memory or on mapped ColdData),
+// functions using cold data take it with its computation area
+UMatrix2D< FlowNodeCold2D<FP,NUM_COMPONENTS> >* CreateColdTable2D(ComputationalMatrix2D* pJ, void* ColdData) {
+    UMatrix2D< FlowNodeCold2D<FP,NUM_COMPONENTS> >* pCold;
+    if(ColdData)
+       pCold = new UMatrix2D< FlowNodeCold2D<FP,NUM_COMPONENTS> >((FlowNodeCold2D<FP,NUM_COMPONENTS>*)ColdData,pJ->GetX(),pJ->GetY());
+    else
+       pCold = new UMatrix2D< FlowNodeCold2D<FP,NUM_COMPONENTS> >(pJ->GetX(),pJ->GetY());
+    return pCold;
+}
+
 #ifdef _PARALLEL_RECALC_Y_PLUS_
 void RecalcWallFrictionVelocityArray2D(ComputationalMatrix2D* pJ,
                                        UArray<FP>* WallFrictionVelocityArray2D,
@@ -2289,31 +3349,44 @@ UArray<FP>* GetWallFrictionVelocityArray2D(ComputationalMatrix2D* pJ,
 }
 
 void ParallelRecalc_y_plus(ComputationalMatrix2D* pJ, 
+                           ColdMatrix2D* pCold,
                            UArray< XY<int> >* WallNodes,
                            UArray<FP>* WallFrictionVelocity2D,
-                           FP x0) {
+                           FP x0, FP y0,
+                           NodeSpanList2D<FP,NUM_COMPONENTS>* Spans) {
+    NodeSpanList2D<FP,NUM_COMPONENTS>* pSpans = Spans;
+    UMatrixView2D< FlowNode2D<FP,NUM_COMPONENTS> > v(pJ);
+
+    if(!pSpans)
+       pSpans = new NodeSpanList2D<FP,NUM_COMPONENTS>(pJ);
+
 #ifndef _OLD_Y_PLUS_
 
+    v.CheckRange(0,v.GetX(),0,v.GetY());
+
 #ifdef _OPEN_MP
 #pragma omp parallel for
 #endif //_OPEN_MP
     for (int i=0;i<(int)pJ->GetX();i++ ) {
-            for (int j=0;j<(int)pJ->GetY();j++ ) {
-                 if ( pJ->GetValue(i,j).isCond2D(CT_NODE_IS_SET_2D) &&
-                      !pJ->GetValue(i,j).isCond2D(CT_SOLID_2D)) {
+            for (NodeSpan2D* s = pSpans->Begin(NST_FLOW,i);s<pSpans->End(NST_FLOW,i);s++ )
+            for (int j=(int)s->j_start;j<(int)s->j_end;j++ ) {
+                 FlowNode2D<FP,NUM_COMPONENTS>* CurrentNode = &v(i,j);
+                 if ( CurrentNode->isCond2D(CT_NODE_IS_SET_2D) &&
+                      !CurrentNode->isCond2D(CT_SOLID_2D)) {
+                        const unsigned int i_wall = pCold->GetValue(i,j).i_wall;
+                        const unsigned int j_wall = pCold->GetValue(i,j).j_wall;
                         for (int ii=0;ii<(int)WallNodes->GetNumElements();ii++) {
                              
                              unsigned int iw,jw;
-                             FP U_w,x,y,wx,wy;
+                             FP U_w;
 
                              iw = WallNodes->GetElementPtr(ii)->GetX();
                              jw = WallNodes->GetElementPtr(ii)->GetY();
 
-                             U_w   =  WallFrictionVelocity2D->GetElement(ii);
-                             
-                             if(iw == pJ->GetValue(i,j).i_wall && 
-                                jw == pJ->GetValue(i,j).j_wall ) {
-                                 pJ->GetValue(i,j).y_plus = fabs(U_w*pJ->GetValue(i,j).l_min*pJ->GetValue(i,j).S[i2d_Rho]/pJ->GetValue(i,j).mu);
+                             if(iw == i_wall && 
+                                jw == j_wall ) {
+                                 U_w   =  WallFrictionVelocity2D->GetElement(ii);
+                                 CurrentNode->y_plus = fabs(U_w*CurrentNode->l_min*CurrentNode->S[i2d_Rho]/CurrentNode->mu);
                              }
                         }
                  }
@@ -2325,7 +3398,8 @@ void ParallelRecalc_y_plus(ComputationalMatrix2D* pJ,
 #pragma omp parallel for
 #endif //_OPEN_MP
         for (int i=0;i<(int)pJ->GetX();i++ ) {
-            for (int j=0;j<(int)pJ->GetY();j++ ) {
+            for (NodeSpan2D* s = pSpans->Begin(NST_FLOW,i);s<pSpans->End(NST_FLOW,i);s++ )
+            for (int j=(int)s->j_start;j<(int)s->j_end;j++ ) {
                  if ( pJ->GetValue(i,j).isCond2D(CT_NODE_IS_SET_2D) &&
                       !pJ->GetValue(i,j).isCond2D(CT_SOLID_2D)) {
                         
@@ -2340,7 +3414,7 @@ void ParallelRecalc_y_plus(ComputationalMatrix2D* pJ,
                              U_w   =  WallFrictionVelocity2D->GetElement(ii);
 
                              x = x0 + i * FlowNode2D<FP,NUM_COMPONENTS>::dx;
-                             y = j * FlowNode2D<FP,NUM_COMPONENTS>::dy;
+                             y = y0 + j * FlowNode2D<FP,NUM_COMPONENTS>::dy;
 
                              wx = iw * FlowNode2D<FP,NUM_COMPONENTS>::dx;
                              wy = jw * FlowNode2D<FP,NUM_COMPONENTS>::dy;
@@ -2359,9 +3433,12 @@ void ParallelRecalc_y_plus(ComputationalMatrix2D* pJ,
         }
 
 #endif // _OLD_Y_PLUS_
+
+    if(pSpans != Spans)
+       delete pSpans;
 }
 #else
-void Recalc_y_plus(ComputationalMatrix2D* pJ, UArray< XY<int> >* WallNodes) {
+void Recalc_y_plus(ComputationalMatrix2D* pJ, ColdMatrix2D* pCold, UArray< XY<int> >* WallNodes) {
     unsigned int iw,jw;
     FP tau_w, U_w;
     
@@ -2369,8 +3446,8 @@ void Recalc_y_plus(ComputationalMatrix2D* pJ, UArray< XY<int> >* WallNodes) {
            for (int j=0;j<(int)pJ->GetY();j++ ) {
                if (pJ->GetValue(i,j).isCond2D(CT_NODE_IS_SET_2D) &&
                    !pJ->GetValue(i,j).isCond2D(CT_SOLID_2D)) {
-                   iw = pJ->GetValue(i,j).i_wall;
-                   jw = pJ->GetValue(i,j).j_wall;
+                   iw = pCold->GetValue(i,j).i_wall;
+                   jw = pCold->GetValue(i,j).j_wall;
                    tau_w = (fabs(pJ->GetValue(iw,jw).dUdy) + fabs(pJ->GetValue(iw,jw).dVdx)) * pJ->GetValue(iw,jw).mu;
                    if (pJ->GetValue(iw,jw).S[i2d_Rho] > 0.0 &&
                        tau_w > 0.0) {
@@ -2587,6 +3664,12 @@ void SaveRMS(ofstream* OutputData,unsigned int n, FP* outRMS) {
     }
 
     void SaveData2D(ofstream* OutputData, int type) { // type = 1 - GNUPLOT
+        SaveData2D(OutputData,type,J,GlobalTime);
+    }
+
+    // Save field pJ (J or its snapshot copy) at time t
+    void SaveData2D(ofstream* OutputData, int type,
+                    UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* pJ, FP t) {
         int    i,j;
         char   TechPlotTitle1[1024]={0};
         char   TechPlotTitle2[256]={0};
@@ -2605,7 +3688,7 @@ void SaveRMS(ofstream* OutputData,unsigned int n, FP* outRMS) {
 
         snprintf(TechPlotTitle1,1024,"VARIABLES = X, %s, U, V, T, p, Rho, Y_fuel, Y_ox, Y_cp, Y_i, %s, Mach, l_min, y+, Cp"
                                      "\n",YR, RT); 
-        snprintf(TechPlotTitle2,256,"ZONE T=\"Time: %g sec.\" I= %i J= %i F=POINT\n",GlobalTime, MaxX, MaxY);
+        snprintf(TechPlotTitle2,256,"ZONE T=\"Time: %g sec.\" I= %i J= %i F=POINT\n",t, MaxX, MaxY);
 
         if ( type ) {
             *OutputData <<  TechPlotTitle1;
@@ -2624,46 +3707,46 @@ void SaveRMS(ofstream* OutputData,unsigned int n, FP* outRMS) {
                 *OutputData << i*dx_out*1.e3                    << "  "; // 1
                 *OutputData << dy_out*j*1.e3                    << "  "; // 2
                 Mach = Re = Re_t = 0;
-                if ( !J->GetValue(i,j).isCond2D(CT_SOLID_2D) ) {
-                    *OutputData << J->GetValue(i,j).U           << "  "; // 3
-                    *OutputData << J->GetValue(i,j).V           << "  "; // 4
-                    *OutputData << J->GetValue(i,j).Tg          << "  "; // 5
-                    *OutputData << J->GetValue(i,j).p           << "  "; // 6
-                    *OutputData << J->GetValue(i,j).S[0]        << "  "; // 7
+                if ( !pJ->GetValue(i,j).isCond2D(CT_SOLID_2D) ) {
+                    *OutputData << pJ->GetValue(i,j).U           << "  "; // 3
+                    *OutputData << pJ->GetValue(i,j).V           << "  "; // 4
+                    *OutputData << pJ->GetValue(i,j).Tg          << "  "; // 5
+                    *OutputData << pJ->GetValue(i,j).p           << "  "; // 6
+                    *OutputData << pJ->GetValue(i,j).S[0]        << "  "; // 7
                     
-                    A = sqrt(J->GetValue(i,j).k*J->GetValue(i,j).R*J->GetValue(i,j).Tg+1.e-30);
-                    W = sqrt(J->GetValue(i,j).U*J->GetValue(i,j).U+J->GetValue(i,j).V*J->GetValue(i,j).V+1.e-30);
+                    A = sqrt(pJ->GetValue(i,j).k*pJ->GetValue(i,j).R*pJ->GetValue(i,j).Tg+1.e-30);
+                    W = sqrt(pJ->GetValue(i,j).U*pJ->GetValue(i,j).U+pJ->GetValue(i,j).V*pJ->GetValue(i,j).V+1.e-30);
                     Mach = W/A;
                     
-                    if ( J->GetValue(i,j).S[0] != 0. ) {
-                        *OutputData << J->GetValue(i,j).S[4]/J->GetValue(i,j).S[0] << "  ";  // 8
-                        *OutputData << J->GetValue(i,j).S[5]/J->GetValue(i,j).S[0] << "  ";  // 9
-                        *OutputData << J->GetValue(i,j).S[6]/J->GetValue(i,j).S[0] << "  ";  // 10
-                        *OutputData << fabs(1-J->GetValue(i,j).S[4]/J->GetValue(i,j).S[0]-J->GetValue(i,j).S[5]/J->GetValue(i,j).S[0]-J->GetValue(i,j).S[6]/J->GetValue(i,j).S[0]) << "  "; //11
+                    if ( pJ->GetValue(i,j).S[0] != 0. ) {
+                        *OutputData << pJ->GetValue(i,j).S[4]/pJ->GetValue(i,j).S[0] << "  ";  // 8
+                        *OutputData << pJ->GetValue(i,j).S[5]/pJ->GetValue(i,j).S[0] << "  ";  // 9
+                        *OutputData << pJ->GetValue(i,j).S[6]/pJ->GetValue(i,j).S[0] << "  ";  // 10
+                        *OutputData << fabs(1-pJ->GetValue(i,j).S[4]/pJ->GetValue(i,j).S[0]-pJ->GetValue(i,j).S[5]/pJ->GetValue(i,j).S[0]-pJ->GetValue(i,j).S[6]/pJ->GetValue(i,j).S[0]) << "  "; //11
 
                         if(is_p_asterisk_out)
-                          *OutputData << p_asterisk(&(J->GetValue(i,j))) << "  ";            // 12
+                          *OutputData << p_asterisk(&(pJ->GetValue(i,j))) << "  ";            // 12
                         else
-                          *OutputData << J->GetValue(i,j).mu_t/J->GetValue(i,j).mu << "  ";  // 12
+                          *OutputData << pJ->GetValue(i,j).mu_t/pJ->GetValue(i,j).mu << "  ";  // 12
                         
                     } else {
                         *OutputData << " +0. +0  +0  +0  +0  "; /* 8 9 10 11 12 */
                     }
                 } else {
                     *OutputData << "  0  0  ";                     /* 3 4 */
-                    *OutputData << J->GetValue(i,j).Tg;            /* 5 */
+                    *OutputData << pJ->GetValue(i,j).Tg;            /* 5 */
                     *OutputData << "  0  0  0  0  0  0  0";        /* 6 7 8 9 10 11 12 */
                 }
-                if(!J->GetValue(i,j).isCond2D(CT_SOLID_2D)) {
+                if(!pJ->GetValue(i,j).isCond2D(CT_SOLID_2D)) {
                     if( Mach > 1.e-30) 
-                      *OutputData << Mach  << "  " << J->GetValue(i,j).l_min << " " << J->GetValue(i,j).y_plus;  
+                      *OutputData << Mach  << "  " << pJ->GetValue(i,j).l_min << " " << pJ->GetValue(i,j).y_plus;  
                     else
                       *OutputData << "  0  0  0  ";
                 } else {
                     *OutputData << "  0  0  0  ";
                 }
                 if(is_Cx_calc)
-                   *OutputData << " " << Calc_Cp(&J->GetValue(i,j),Flow2DList->GetElement(Cx_Flow_index-1)) << "\n" ;
+                   *OutputData << " " << Calc_Cp(&pJ->GetValue(i,j),Flow2DList->GetElement(Cx_Flow_index-1)) << "\n" ;
                 else
                   *OutputData << " 0\n"; 
             }
@@ -2676,30 +3759,42 @@ void SaveRMS(ofstream* OutputData,unsigned int n, FP* outRMS) {
         return(Cp/(Cp-R));
     }
 
-inline  void CalcHeatOnWallSources(UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* F, FP dx, FP dy, FP dt, int rank, int last_rank) {
-
-        unsigned int StartXLocal,MaxXLocal;
+// Heat sources of wall nodes in columns i_start...i_end-1, rows StartYLocal...MaxYLocal-1 of F
+// (Cold - cold records of nodes of F, Cold[n] for node n of F)
+inline  void CalcHeatOnWallSources(UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* F, FP dx, FP dy, FP dt, int i_start, int i_end,
+                                   int StartYLocal, int MaxYLocal,
+                                   NodeSpanList2D<FP,NUM_COMPONENTS>* Spans, long col_offset,
+                                   FlowNodeCold2D<FP,NUM_COMPONENTS>* Cold) {
+
+        const unsigned int StartXLocal = i_start;
+        const unsigned int MaxXLocal   = i_end;
+        const int    j_lo = max(StartYLocal-1,0);                 // own rows and halo rows
+        const int    j_hi = min(MaxYLocal+1,(int)F->GetY());
         FP dx_local, dy_local;
-
-        if( rank == 0) {
-            StartXLocal = 0;
-        } else {
-            StartXLocal = 1;
-        }
-
-        if( rank == last_rank) {
-            MaxXLocal=F->GetX();
-        } else {
-            MaxXLocal=F->GetX()-1;
-        }
-        // Clean Q
-        for (unsigned int i=StartXLocal;i<MaxXLocal;i++ )
-            for ( unsigned int j=0;j<F->GetY();j++ ) {
-                 F->GetValue(i,j).Q_conv = 0.;
+        UMatrixView2D< FlowNode2D<FP,NUM_COMPONENTS> > v(F);
+        UStencil2D st;
+        v.CheckRange(StartXLocal > 0 ? StartXLocal-1 : 0,min(MaxXLocal+1,v.GetX()),j_lo,j_hi);
+
+        // Clean Q (Q_conv is set in solid nodes near wall only)
+        for (unsigned int i=(StartXLocal > 0 ? StartXLocal-1 : 0);i<min(MaxXLocal+1,v.GetX());i++ )
+            for (NodeSpan2D* s = Spans->Begin(NST_WALL,i+col_offset);s<Spans->End(NST_WALL,i+col_offset);s++ )
+            for ( int j=max((int)s->j_start,j_lo);j<min((int)s->j_end,j_hi);j++ ) {
+                 const int is_own_i = (i >= StartXLocal && i < MaxXLocal);
+                 const int is_own_j = (j >= StartYLocal && j < MaxYLocal);
+                 v.Stencil(i,j,&st);
+                 if(st.U != st.C && is_own_i && j+1 >= StartYLocal && j+1 < MaxYLocal && v[st.U].isCond2D(CT_SOLID_2D))
+                    Cold[st.U].Q_conv = 0.;
+                 if(st.D != st.C && is_own_i && j-1 >= StartYLocal && j-1 < MaxYLocal && v[st.D].isCond2D(CT_SOLID_2D))
+                    Cold[st.D].Q_conv = 0.;
+                 if(i > StartXLocal && is_own_j && v[st.L].isCond2D(CT_SOLID_2D))
+                    Cold[st.L].Q_conv = 0.;
+                 if(i+1 < MaxXLocal && is_own_j && v[st.R].isCond2D(CT_SOLID_2D))
+                    Cold[st.R].Q_conv = 0.;
             }
 
         for (unsigned int i=StartXLocal;i<MaxXLocal;i++ )
-            for ( unsigned int j=0;j<F->GetY();j++ ) {
+            for (NodeSpan2D* s = Spans->Begin(NST_WALL,i+col_offset);s<Spans->End(NST_WALL,i+col_offset);s++ )
+            for ( int j=max((int)s->j_start,StartYLocal);j<min((int)s->j_end,MaxYLocal);j++ ) {
 
                 FlowNode2D< FP,NUM_COMPONENTS >* CurrentNode=NULL;
                 FlowNode2D< FP,NUM_COMPONENTS >* UpNode=NULL;
@@ -2708,32 +3803,20 @@ inline  void CalcHeatOnWallSources(UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* F
                 FlowNode2D< FP,NUM_COMPONENTS >* RightNode=NULL;
 
 
-                CurrentNode = &F->GetValue(i,j);
+                v.Stencil(i,j,&st);
+
+                CurrentNode = &v[st.C];
 
                 if(!CurrentNode->isCond2D(CT_SOLID_2D)) { //  && CurrentNode->isCleanSources == 1
                     
                     dx_local = dx;
                     dy_local = dy;
 
-                    if(j < F->GetY()-1)
-                      UpNode    = &(F->GetValue(i,j+1));
-                    else
-                      UpNode    = NULL;
-
-                    if(j>0)
-                      DownNode  = &(F->GetValue(i,j-1));
-                    else
-                      DownNode  = NULL;
-
-                    if(i>0)
-                      LeftNode  = &(F->GetValue(i-1,j));
-                    else
-                      LeftNode  = NULL;
-
-                    if(i < F->GetX()-1)
-                      RightNode = &(F->GetValue(i+1,j));
-                    else
-                      RightNode = NULL;
+                    // neighbors outside matrix are absent (stencil index is node itself)
+                    UpNode    = (st.U != st.C) ? &v[st.U] : NULL;
+                    DownNode  = (st.D != st.C) ? &v[st.D] : NULL;
+                    LeftNode  = (st.L != st.C) ? &v[st.L] : NULL;
+                    RightNode = (st.R != st.C) ? &v[st.R] : NULL;
 
                 if ( CurrentNode->isCond2D(CT_WALL_LAW_2D) || 
                      CurrentNode->isCond2D(CT_WALL_NO_SLIP_2D)) { 
@@ -2749,19 +3832,14 @@ inline  void CalcHeatOnWallSources(UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* F
                         num_near_nodes = 1;
                         lam_eff = CurrentNode->lam+CurrentNode->lam_t; 
                         
-                        if (CurrentNode->UpNode) {
-                            lam_eff +=CurrentNode->UpNode->lam + CurrentNode->UpNode->lam_t;
-                            num_near_nodes++;
-                        }
-                        
                         lam_eff = lam_eff/num_near_nodes;
                         
-                        if(DownNode->Q_conv > 0.)
-                           DownNode->Q_conv = (DownNode->Q_conv - lam_eff*(DownNode->Tg - CurrentNode->Tg)/dy_local)*0.5;
+                        if(Cold[st.D].Q_conv > 0.)
+                           Cold[st.D].Q_conv = (Cold[st.D].Q_conv - lam_eff*(DownNode->Tg - CurrentNode->Tg)/dy_local)*0.5;
                         else
-                           DownNode->Q_conv = -lam_eff*(DownNode->Tg - CurrentNode->Tg)/dy_local;
+                           Cold[st.D].Q_conv = -lam_eff*(DownNode->Tg - CurrentNode->Tg)/dy_local;
                         
-                        CurrentNode->SrcAdd[i2d_RhoE] = -dt*DownNode->Q_conv/dy;
+                        CurrentNode->SrcAdd[i2d_RhoE] = -dt*Cold[st.D].Q_conv/dy;
                         //CurrentNode->SrcAdd[i2d_RhoE] += dt*lam_eff*(DownNode->Tg - CurrentNode->Tg)/dy2;
                     }
                     
@@ -2770,19 +3848,14 @@ inline  void CalcHeatOnWallSources(UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* F
                         num_near_nodes = 1;
                         lam_eff = CurrentNode->lam+CurrentNode->lam_t; 
                         
-                        if (CurrentNode->DownNode) {
-                            lam_eff +=CurrentNode->DownNode->lam + CurrentNode->DownNode->lam_t;
-                            num_near_nodes++;
-                        }
-                        
                         lam_eff = lam_eff/num_near_nodes;
                         
-                        if(UpNode->Q_conv > 0.)
-                           UpNode->Q_conv = (UpNode->Q_conv - lam_eff*(UpNode->Tg - CurrentNode->Tg)/dy_local)*0.5;
+                        if(Cold[st.U].Q_conv > 0.)
+                           Cold[st.U].Q_conv = (Cold[st.U].Q_conv - lam_eff*(UpNode->Tg - CurrentNode->Tg)/dy_local)*0.5;
                         else
-                           UpNode->Q_conv = -lam_eff*(UpNode->Tg - CurrentNode->Tg)/dy_local;
+                           Cold[st.U].Q_conv = -lam_eff*(UpNode->Tg - CurrentNode->Tg)/dy_local;
                         
-                        CurrentNode->SrcAdd[i2d_RhoE] = -dt*UpNode->Q_conv/dy;
+                        CurrentNode->SrcAdd[i2d_RhoE] = -dt*Cold[st.U].Q_conv/dy;
                         //CurrentNode->SrcAdd[i2d_RhoE] += dt*lam_eff*(UpNode->Tg - CurrentNode->Tg)/dy2;
                     }
                     
@@ -2791,19 +3864,14 @@ inline  void CalcHeatOnWallSources(UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* F
                         num_near_nodes = 1;
                         lam_eff = CurrentNode->lam+CurrentNode->lam_t; 
                         
-                        if (CurrentNode->RightNode) {
-                            lam_eff +=CurrentNode->RightNode->lam + CurrentNode->RightNode->lam_t;
-                            num_near_nodes++;
-                        }
-                        
                         lam_eff = lam_eff/num_near_nodes;
                         
-                        if(LeftNode->Q_conv > 0.)
-                           LeftNode->Q_conv = (LeftNode->Q_conv - lam_eff*(LeftNode->Tg - CurrentNode->Tg)/dx_local)*0.5;
+                        if(Cold[st.L].Q_conv > 0.)
+                           Cold[st.L].Q_conv = (Cold[st.L].Q_conv - lam_eff*(LeftNode->Tg - CurrentNode->Tg)/dx_local)*0.5;
                         else
-                           LeftNode->Q_conv = -lam_eff*(LeftNode->Tg - CurrentNode->Tg)/dx_local;
+                           Cold[st.L].Q_conv = -lam_eff*(LeftNode->Tg - CurrentNode->Tg)/dx_local;
                         
-                        CurrentNode->SrcAdd[i2d_RhoE] = -dt*LeftNode->Q_conv/dx;
+                        CurrentNode->SrcAdd[i2d_RhoE] = -dt*Cold[st.L].Q_conv/dx;
                         //CurrentNode->SrcAdd[i2d_RhoE] += dt*lam_eff*(LeftNode->Tg - CurrentNode->Tg)/dx2;
                     }
                     
@@ -2812,19 +3880,14 @@ inline  void CalcHeatOnWallSources(UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* F
                         num_near_nodes = 1;
                         lam_eff = CurrentNode->lam+CurrentNode->lam_t; 
                         
-                        if (CurrentNode->LeftNode) {
-                            lam_eff +=CurrentNode->LeftNode->lam + CurrentNode->LeftNode->lam_t;
-                            num_near_nodes++;
-                        }
-                        
                         lam_eff = lam_eff/num_near_nodes;
                         
-                        if(RightNode->Q_conv > 0.)
-                           RightNode->Q_conv = (RightNode->Q_conv - lam_eff*(RightNode->Tg - CurrentNode->Tg)/dx_local)*0.5;
+                        if(Cold[st.R].Q_conv > 0.)
+                           Cold[st.R].Q_conv = (Cold[st.R].Q_conv - lam_eff*(RightNode->Tg - CurrentNode->Tg)/dx_local)*0.5;
                         else
-                           RightNode->Q_conv = -lam_eff*(RightNode->Tg - CurrentNode->Tg)/dx_local;
+                           Cold[st.R].Q_conv = -lam_eff*(RightNode->Tg - CurrentNode->Tg)/dx_local;
                         
-                        CurrentNode->SrcAdd[i2d_RhoE] = -dt*RightNode->Q_conv/dx;
+                        CurrentNode->SrcAdd[i2d_RhoE] = -dt*Cold[st.R].Q_conv/dx;
                         //CurrentNode->SrcAdd[i2d_RhoE] += dt*lam_eff*(RightNode->Tg - CurrentNode->Tg)/dx2;
                     }
                 }
@@ -3218,6 +4281,24 @@ void* InitDEEPS2D(void* lpvParam)
                         unlink(GasSwapFileName);
                     }
                 }
+            // Cold side-table (time, Tf, wall data) is saved in separate swap file,
+            // without it gas area is loaded and cold side-table is rebuilt (time 0)
+            volatile int isColdRebuild = 0;
+            if ( GasSwapData != 0 ) {
+                int p_c = 0;
+                snprintf(ColdSwapFileName,260,"%s.cold",GasSwapFileName);
+                ColdSwapData  = LoadSwapFile2D(ColdSwapFileName,
+                                               (int)MaxX,
+                                               (int)MaxY,
+                                               sizeof(FlowNodeCold2D<FP,NUM_COMPONENTS>),
+                                               &p_c,
+                                               &fd_c,
+                                               f_stream);
+                isColdRebuild = PreloadFlag && !p_c;
+                if ( isColdRebuild )
+                    *f_stream << "\nWARNING: Cold swap file " << ColdSwapFileName
+                              << " not found, gas area is loaded, cold data (time, Tf, wall data) are rebuilt.\n" << flush;
+            }
 #ifdef _DEBUG_0
             ___try {
 #endif  // _DEBUG_0
@@ -3238,6 +4319,14 @@ void* InitDEEPS2D(void* lpvParam)
                     }
                     J = new UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >(MaxX,MaxY);
                 }
+                ColdJ = CreateColdTable2D(J,ColdSwapData);
+                if ( !PreloadFlag || isColdRebuild )
+                    memset(ColdJ->GetMatrixPtr(),0,ColdJ->GetMatrixSize());
+                if ( isColdRebuild ) {      // wall data - SetMinDistanceToWall2D(), Tf of sources - SetSources2D()
+                    for (int i=0;i<(int)MaxX;i++ )
+                        for (int j=0;j<(int)MaxY;j++ )
+                             ColdJ->GetValue(i,j).Tf = chemical_reactions.Tf;
+                }
 #ifdef _DEBUG_0
             } __except( ComputationalMatrix2D*  m) {  // ExceptLib know bug...
 #endif  // _DEBUG_0
@@ -3252,6 +4341,8 @@ void* InitDEEPS2D(void* lpvParam)
 #endif  // _DEBUG_0
 
             *f_stream << "OK\n" << flush;
+            *f_stream << "FlowNode2D size = " << sizeof(FlowNode2D<FP,NUM_COMPONENTS>) << " bytes\n"
+                      << "FlowNodeCold2D size = " << sizeof(FlowNodeCold2D<FP,NUM_COMPONENTS>) << " bytes\n" << flush;
             f_stream->flush();
 
 
@@ -3876,7 +4967,7 @@ void* InitDEEPS2D(void* lpvParam)
                           //     J->GetValue(i,j).r     = (j+1)*dy;
                           J->GetValue(i,j).x     = (i+0.5)*dx;
                           J->GetValue(i,j).y     = (j+0.5)*dy;
-                          J->GetValue(i,j).Tf    = chemical_reactions.Tf;
+                          ColdJ->GetValue(i,j).Tf = chemical_reactions.Tf;
                           J->GetValue(i,j).BGX   = 1.;
                           J->GetValue(i,j).BGY   = 1.;
                           J->GetValue(i,j).NGX   = 0;
@@ -4616,9 +5707,11 @@ void* InitDEEPS2D(void* lpvParam)
 #endif  // _DEBUG_0
 
             if(GlobalTime > 0.)
-               J->GetValue(0,0).time = GlobalTime;
+               ColdJ->GetValue(0,0).time = GlobalTime;
             else
-               GlobalTime=J->GetValue(0,0).time;
+               GlobalTime=ColdJ->GetValue(0,0).time;
+            if(PreloadFlag)
+               *f_stream << "\nRestart from swap file \"" << GasSwapFileName << "\" at time " << GlobalTime << " sec." << endl;
 
             *f_stream << "\nInitial dt=" << dt << "sec." << endl;
 //------> place here <------*
@@ -4627,12 +5720,48 @@ void* InitDEEPS2D(void* lpvParam)
            }
             
             GlobalSubDomain = ScanArea(f_stream,J, isVerboseOutput);
+
+            snprintf(CostFileName,255,"%s.cost",ProjectName);
+            if(RebalanceStep > 0) {
+               FP* col_cost = LoadColumnCost(CostFileName);
+               if(col_cost) {
+                  UArray< XY<int> >* sd = SplitSubDomains(col_cost,(int)GlobalSubDomain->GetNumElements());
+                  if(sd) {
+                     *f_stream << "SubDomain decomposition by measured cost (" << CostFileName << "):\n";
+                     for(unsigned int k=0;k<sd->GetNumElements();k++)
+                         *f_stream << "SubDomain[" << k << "]->["<< sd->GetElementPtr(k)->GetX() <<","<< sd->GetElementPtr(k)->GetY() <<"]\n";
+                     delete GlobalSubDomain;
+                     GlobalSubDomain = sd;
+                  }
+                  delete[] col_cost;
+               }
+            }
+#ifdef _MPI
+            if(ProcGridY > 1) {
+               GlobalSubDomainY = SplitRows2D(J);
+               if(!GlobalSubDomainY) {
+                  *f_stream << "ERROR: can't split " << MaxY << " rows to " << ProcGridY << " rows of process grid.\n" << flush;
+                  Abort_OpenHyperFLOW2D();
+               }
+               for(unsigned int k=0;k<GlobalSubDomainY->GetNumElements();k++)
+                   *f_stream << "SubDomainY[" << k << "]->["<< GlobalSubDomainY->GetElementPtr(k)->GetX() <<","<< GlobalSubDomainY->GetElementPtr(k)->GetY() <<"]\n";
+            } else {
+               XY<int> all_rows(0,(int)MaxY);
+
+               GlobalSubDomainY = new UArray< XY<int> >();
+               GlobalSubDomainY->AddElement(&all_rows);
+            }
+            if((int)GlobalSubDomain->GetNumElements() != ProcGridX) {
+               *f_stream << "ERROR: " << GlobalSubDomain->GetNumElements() << " subdomains for " << ProcGridX << " columns of process grid.\n" << flush;
+               Abort_OpenHyperFLOW2D();
+            }
+#endif // _MPI
 /* Load additional sources */
              isGasSource  = Data->GetIntVal((char*)"NumSrc");
              if ( Data->GetDataError()==-1 ) Abort_OpenHyperFLOW2D();
 
              if ( isGasSource ) {
-                  SrcList = new SourceList2D(J,Data);
+                  SrcList = new SourceList2D(J,ColdJ,Data);
                   SrcList->SetSources2D();
              }
 
@@ -4644,7 +5773,7 @@ void* InitDEEPS2D(void* lpvParam)
              if(ProblemType == SM_NS) {
                  if(!PreloadFlag) {
                     *f_stream << "Set initial boundary layer...";
-                    SetInitBoundaryLayer(J,delta_bl);
+                    SetInitBoundaryLayer(J,ColdJ,delta_bl);
                     *f_stream << "OK" << endl; 
                    }
              }
@@ -4694,11 +5823,33 @@ int      AddEq = 2;
  return AddEq;
 }
 
-inline int CalcChemicalReactions(FlowNode2D<FP,NUM_COMPONENTS>* CalcNode,
-                                 ChemicalReactionsModel cr_model, void* CRM_data) {
+// Node composition is frozen: no fuel, OX and cp (pure air), so reaction,
+// normalization and S[i2d_Yfu...i2d_Ycp] update leave node unchanged.
+inline int isFrozenComposition2D(FlowNode2D<FP,NUM_COMPONENTS>* CalcNode) {
+    return CalcNode->S[i2d_Yfu] == 0. && CalcNode->S[i2d_Yox] == 0. &&
+           CalcNode->S[i2d_Ycp] == 0. && CalcNode->S[0] != 0.;
+}
+
+// Composition part of CalcChemicalReactions(): reaction, cut-off, normalization,
+// new Y and S[i2d_Yfu...i2d_Ycp] of node. Mass fractions before cut-off
+// (for mixture properties, see CalcMixtureProperties2D()) are saved in c.
+void CalcChemicalComposition2D(FlowNode2D<FP,NUM_COMPONENTS>* CalcNode,
+                               FlowNodeCold2D<FP,NUM_COMPONENTS>* CalcNodeCold,
+                               ChemicalReactionsModel cr_model, void* CRM_data,
+                               NodeComposition2D* c) {
     ChemicalReactionsModelData2D* model_data = (ChemicalReactionsModelData2D*)CRM_data;
     FP   Y0,Yfu,Yox,Ycp,Yair;
 
+    c->isFrozen = isFrozenComposition2D(CalcNode);
+
+    if ( c->isFrozen ) {
+         CalcNode->Y[0] = 0.;
+         CalcNode->Y[1] = 0.;
+         CalcNode->Y[2] = 0.;
+         CalcNode->Y[3] = 1.;
+         return;
+    }
+
     Yfu  = CalcNode->S[i2d_Yfu]/CalcNode->S[0]; // Fuel
     Yox  = CalcNode->S[i2d_Yox]/CalcNode->S[0]; // OX
     Ycp  = CalcNode->S[i2d_Ycp]/CalcNode->S[0]; // cp
@@ -4712,7 +5863,7 @@ inline int CalcChemicalReactions(FlowNode2D<FP,NUM_COMPONENTS>* CalcNode,
           Yox  = Yox*Y0;
           Ycp  = Ycp*Y0;
 
-          if ( CalcNode->Tg > CalcNode->Tf ) {
+          if ( CalcNode->Tg > CalcNodeCold->Tf ) {
               if ( Yox > Yfu*model_data->K0 ) { // Yo2 > Yfuel
                    Yox = Yox - Yfu*model_data->K0;
                    Yfu = 0.;
@@ -4727,24 +5878,10 @@ inline int CalcChemicalReactions(FlowNode2D<FP,NUM_COMPONENTS>* CalcNode,
 //--- chemical reactions (Zeldovich model) -------------------------------------------------->
     }
 
-    CalcNode->R   = model_data->R_Fuel*Yfu+
-                            model_data->R_OX*Yox+
-                            model_data->R_cp*Ycp+
-                            model_data->R_air*Yair;
-    CalcNode->CP  = model_data->Cp_Fuel->GetVal(CalcNode->Tg)*Yfu+
-                            model_data->Cp_OX->GetVal(CalcNode->Tg)*Yox+
-                            model_data->Cp_cp->GetVal(CalcNode->Tg)*Ycp+
-                            model_data->Cp_air->GetVal(CalcNode->Tg)*Yair;
-    if( ProblemType == SM_NS ) {
-        CalcNode->lam = model_data->lam_Fuel->GetVal(CalcNode->Tg)*Yfu+
-                                model_data->lam_OX->GetVal(CalcNode->Tg)*Yox+
-                                model_data->lam_cp->GetVal(CalcNode->Tg)*Ycp+
-                                model_data->lam_air->GetVal(CalcNode->Tg)*Yair;
-        CalcNode->mu  = model_data->mu_Fuel->GetVal(CalcNode->Tg)*Yfu+
-                                model_data->mu_OX->GetVal(CalcNode->Tg)*Yox+
-                                model_data->mu_cp->GetVal(CalcNode->Tg)*Ycp+
-                                model_data->mu_air->GetVal(CalcNode->Tg)*Yair;
-    }
+    c->Y[MS_FUEL] = Yfu;
+    c->Y[MS_OX]   = Yox;
+    c->Y[MS_CP]   = Ycp;
+    c->Y[MS_AIR]  = Yair;
 
     if ( Yair<1.e-5 ) {
          Yair =0.;
@@ -4776,11 +5913,47 @@ inline int CalcChemicalReactions(FlowNode2D<FP,NUM_COMPONENTS>* CalcNode,
           CalcNode->S[i2d_Yox] = fabs(Yox*CalcNode->S[0]);
           CalcNode->S[i2d_Ycp] = fabs(Ycp*CalcNode->S[0]);
      }
+}
+
+// Properties part of CalcChemicalReactions(): R, CP (lam, mu) of nodes
+// CalcNodes[0]...CalcNodes[cnt-1] for compositions c[0]...c[cnt-1]
+// (frozen nodes get air properties only)
+void CalcMixtureProperties2D(FlowNode2D<FP,NUM_COMPONENTS>* CalcNodes,
+                             NodeComposition2D* c, int cnt,
+                             void* CRM_data, unsigned int* prop_hint) {
+    ChemicalReactionsModelData2D* model_data = (ChemicalReactionsModelData2D*)CRM_data;
+
+    for (int l=0;l<cnt;l++ ) {
+        FlowNode2D<FP,NUM_COMPONENTS>* fn = CalcNodes + l;
+
+        if ( c[l].isFrozen ) {
+             if( ProblemType == SM_NS )
+                 GetSpeciesProperties2D(model_data,MS_AIR,fn->Tg,&fn->R,&fn->CP,&fn->lam,&fn->mu,prop_hint);
+             else
+                 GetSpeciesProperties2D(model_data,MS_AIR,fn->Tg,&fn->R,&fn->CP,NULL,NULL,prop_hint);
+        } else {
+             if( ProblemType == SM_NS )
+                 GetMixtureProperties2D(model_data,fn->Tg,c[l].Y,&fn->R,&fn->CP,&fn->lam,&fn->mu,prop_hint);
+             else
+                 GetMixtureProperties2D(model_data,fn->Tg,c[l].Y,&fn->R,&fn->CP,NULL,NULL,prop_hint);
+        }
+    }
+}
+
+inline int CalcChemicalReactions(FlowNode2D<FP,NUM_COMPONENTS>* CalcNode,
+                                 FlowNodeCold2D<FP,NUM_COMPONENTS>* CalcNodeCold,
+                                 ChemicalReactionsModel cr_model, void* CRM_data,
+                                 unsigned int* prop_hint) {
+    NodeComposition2D c;
+
+    CalcChemicalComposition2D(CalcNode,CalcNodeCold,cr_model,CRM_data,&c);
+    CalcMixtureProperties2D(CalcNode,&c,1,CRM_data,prop_hint);
  return 1;
 }
 
 
 void SetMinDistanceToWall2D(ComputationalMatrix2D* pJ2D,
+                            ColdMatrix2D* pCold2D,
                             UArray< XY<int> >* WallNodes2D, 
                             FP x0 ) {
 
@@ -4820,8 +5993,8 @@ for (int i=0;i<(int)pJ2D->GetX();i++ ) {
                              pJ2D->GetValue(i,j).l_min = min(pJ2D->GetValue(i,j).l_min,_l_min);
 
                              if (pJ2D->GetValue(i,j).l_min == _l_min) {
-                                 pJ2D->GetValue(i,j).i_wall = iw;
-                                 pJ2D->GetValue(i,j).j_wall = jw;
+                                 pCold2D->GetValue(i,j).i_wall = iw;
+                                 pCold2D->GetValue(i,j).j_wall = jw;
                              }
                              pJ2D->GetValue(i,j).l_min =  max(min_l_min,pJ2D->GetValue(i,j).l_min);
                         }
@@ -5006,3 +6179,43 @@ off_t offset=0L;
 #endif // _IMPI_
 
 
+
+#ifdef _MPI
+// Send block of nx columns * ny rows at src of column-major matrix with columns
+// of col_len nodes (node_size bytes), contiguous block is sent as bytes,
+// other - as vector datatype (receiver may use other layout of the same block).
+void SendBlock2D(int rank, void* src, int nx, int ny, int col_len, size_t node_size, int data_tag) {
+    if(ny == col_len) {
+#ifdef _IMPI_
+       if(data_tag == tag_Matrix && ny == (int)MaxY) {        // contiguous at both sides
+          LongMatrixSend(rank,src,nx*ny*node_size);  // Low Mem Send subdomain
+          return;
+       }
+#endif // _IMPI_
+       MPI::COMM_WORLD.Send(src,nx*ny*node_size,MPI::BYTE,rank,data_tag);
+    } else {
+       MPI::Datatype BlockType = MPI::BYTE.Create_vector(nx,ny*node_size,col_len*node_size);
+       BlockType.Commit();
+       MPI::COMM_WORLD.Send(src,1,BlockType,rank,data_tag);
+       BlockType.Free();
+    }
+}
+
+// Receive block sent by SendBlock2D() to dst
+void RecvBlock2D(int rank, void* dst, int nx, int ny, int col_len, size_t node_size, int data_tag) {
+    if(ny == col_len) {
+#ifdef _IMPI_
+       if(data_tag == tag_Matrix && ny == (int)MaxY) {
+          LongMatrixRecv(rank,dst,nx*ny*node_size);  // Low Mem Recv subdomain
+          return;
+       }
+#endif // _IMPI_
+       MPI::COMM_WORLD.Recv(dst,nx*ny*node_size,MPI::BYTE,rank,data_tag);
+    } else {
+       MPI::Datatype BlockType = MPI::BYTE.Create_vector(nx,ny*node_size,col_len*node_size);
+       BlockType.Commit();
+       MPI::COMM_WORLD.Recv(dst,1,BlockType,rank,data_tag);
+       BlockType.Free();
+    }
+}
+#endif // _MPI
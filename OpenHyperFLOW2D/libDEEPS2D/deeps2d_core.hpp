@@ -45,7 +45,9 @@
 #include "utl/umatrix2d.hpp"
 #include "obj_data/obj_data.hpp"
 #include "libOpenHyperFLOW2D/hyper_flow2d.hpp"
+#include "libOpenHyperFLOW2D/hyper_flow_node_span.hpp"
 #include "libOutCFD/out_cfd_param.hpp"
+#include "libDEEPS2D/deeps2d_numa.hpp"
 
 #include <stdio.h>
 #include <string.h>
@@ -83,6 +85,23 @@ enum WRITE_MODE {
      WM_REWRITE
 };
 
+// Output of snapshot (see GetSnapshot2D())
+enum SnapshotOutput2D {
+     SNAP_GNUPLOT     = 0x01,    // rewrite OutFileName
+     SNAP_TECPLOT     = 0x02,    // append to TecPlotFileName
+     SNAP_HEAT_FLUX_X = 0x04,
+     SNAP_HEAT_FLUX_Y = 0x08,
+     SNAP_SWAP        = 0x10     // write swap files of gas area and its cold side-table
+};
+
+// Snapshot buffer of asynchronous output
+struct Snapshot2D {
+       UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* pJ;  // copy of J
+       UMatrix2D< FlowNodeCold2D<FP,NUM_COMPONENTS> >* pCold; // copy of ColdJ (SNAP_SWAP only)
+       FP   time;                                        // GlobalTime of snapshot
+       int  out;                                         // SNAP_* flags
+};
+
 enum data_tag {
     tag_MaxX=4000,
     tag_MaxY,
@@ -95,7 +114,11 @@ enum data_tag {
     tag_WallNodesArray,
     tag_WallFrictionVelocity,
     tag_DD,
-    tag_MonitorPoint
+    tag_MonitorPoint,
+    tag_ColdMatrix,
+    tag_MatrixUp,
+    tag_MatrixDown,
+    tag_Y0
 };
 
 struct DD_pack {
@@ -106,6 +129,27 @@ struct DD_pack {
           unsigned int   i,j;    // x,y -coordinates
 };
 
+#ifdef _MPI
+struct Var_pack {
+       FP   dt_min;
+#ifdef __INTEL_COMPILER
+       DD_pack  DD[4+NUM_COMPONENTS+2];
+#else 
+       DD_pack  DD[FlowNode2D<FP,NUM_COMPONENTS>::NumEq];
+#endif //__INTEL_COMPILER
+};
+#endif // _MPI
+
+#ifdef _MPI
+// Block of computation area of rank in 2D process grid (see GetBlock2D()).
+// Local field of rank has HaloDepth more (halo) columns/rows at each side with neighbor.
+struct Block2D {
+       int  i_start, i_end;         // own columns of computation area
+       int  j_start, j_end;         // own rows of computation area
+       int  left, right, down, up;  // neighbor ranks (MPI::PROC_NULL - bound of area)
+};
+#endif // _MPI
+
 struct MonitorPoint {
        XY<FP>  MonitorXY;
        FP      p;
@@ -137,6 +181,7 @@ extern UArray<UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >*>*     SubDomainArray;
 extern UArray<UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >*>* CoreSubDomainArray;
 extern InputData*                            Data;              // Object data loader
 extern UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >*     J;       // Main computation area
+extern UMatrix2D< FlowNodeCold2D<FP,NUM_COMPONENTS> >* ColdJ;   // Cold side-table of main computation area
 extern UArray<Flow*>*                        FlowList;          // Flow list
 extern unsigned int                          MaxX;
 extern unsigned int                          MaxY;
@@ -153,6 +198,8 @@ extern char                                  OutFileName[255];
 extern const char*                           PrintTurbCond(int TM);
 extern void*                                 InitDEEPS2D(void*);
 extern void                                  SaveData2D(ofstream* OutputData, int);
+extern void                                  SaveData2D(ofstream* OutputData, int,
+                                                        UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* pJ, FP t);
 extern ofstream*                             OpenData(char* outputDataFile);
 extern void                                  SaveRMSHeader(ofstream* OutputData);
 extern void                                  SaveRMS(ofstream* OutputData,unsigned int n, FP* outRMS);
@@ -167,14 +214,62 @@ extern u_long                                SetWallNodes(ofstream* f_str, Compu
 extern void                                  LongMatrixSend(int rank, void* src,  size_t len);
 extern void                                  LongMatrixRecv(int rank, void* dst,  size_t len);
 #endif // _IMPI_
+#ifdef _MPI
+extern void                                  SendBlock2D(int rank, void* src, int nx, int ny, int col_len,
+                                                         size_t node_size, int data_tag);
+extern void                                  RecvBlock2D(int rank, void* dst, int nx, int ny, int col_len,
+                                                         size_t node_size, int data_tag);
+#endif // _MPI
 extern void SetInitialSources(UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* pJ);
-extern void SetInitBoundaryLayer(ComputationalMatrix2D* pJ, FP delta);
+extern void SetInitBoundaryLayer(ComputationalMatrix2D* pJ, ColdMatrix2D* pCold, FP delta);
+extern UMatrix2D< FlowNodeCold2D<FP,NUM_COMPONENTS> >* CreateColdTable2D(ComputationalMatrix2D* pJ, void* ColdData=NULL);
 extern int  SetTurbulenceModel(FlowNode2D<FP,NUM_COMPONENTS>* pJ);
 extern void DataSnapshot(char* filename, WRITE_MODE ioMode=WM_REWRITE);
-extern void CalcHeatOnWallSources(UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* F, FP dx, FP dr, FP dt, int rank, int last_rank);
+extern void        StartSnapshotWriter2D(ofstream* f_stream);
+extern Snapshot2D* GetSnapshot2D(FP t);
+extern void        PostSnapshot2D(Snapshot2D* s);
+extern void        WaitSnapshotWriter2D();
+extern void        StopSnapshotWriter2D();
+extern void CalcHeatOnWallSources(UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* F, FP dx, FP dr, FP dt, int i_start, int i_end,
+                                  int StartYLocal, int MaxYLocal,
+                                  NodeSpanList2D<FP,NUM_COMPONENTS>* Spans, long col_offset,
+                                  FlowNodeCold2D<FP,NUM_COMPONENTS>* Cold);
 extern UArray< XY<int> >* ScanArea(ofstream* f_str,ComputationalMatrix2D* pJ ,int isPrint);
+extern void SetColumnCost(ComputationalMatrix2D* pJ, UArray< XY<int> >* sd, FP* sd_time, FP* col_cost);
+extern UArray< XY<int> >* SplitSubDomains(FP* col_cost, int n_parts, int n_col=0);
+extern int  SaveColumnCost(char* FileName, FP* col_cost);
+extern FP*  LoadColumnCost(char* FileName);
+extern void RebalanceSubDomains(ofstream* f_stream, FP* sd_time);
+#ifdef _MPI
+extern int                 ProcGridX, ProcGridY;
+extern int                 HaloDepth;
+extern UArray< XY<int> >*  GlobalSubDomainY;
+extern void InitProcGrid2D(InputData* _data, int rank);
+extern UArray< XY<int> >* SplitRows2D(ComputationalMatrix2D* pJ);
+extern void BcastSubDomains2D(int rank);
+extern void GetBlock2D(int r, Block2D* b);
+#endif // _MPI
+#ifndef _MPI
+extern void SetSubDomains2D(UArray< XY<int> >* sd);
+extern void PinThreads2D(ofstream* f_stream);
+extern void PrintPlacement2D(ofstream* f_stream);
+#endif // _MPI
 extern int CalcChemicalReactions(FlowNode2D<FP,NUM_COMPONENTS>* CalcNode,
-                                 ChemicalReactionsModel cr_model, void* CRM_data);
+                                 FlowNodeCold2D<FP,NUM_COMPONENTS>* CalcNodeCold,
+                                 ChemicalReactionsModel cr_model, void* CRM_data,
+                                 unsigned int* prop_hint = NULL);
+// Mass fractions of node for mixture properties (see CalcChemicalComposition2D())
+struct NodeComposition2D {
+       FP   Y[MS_NUM];
+       int  isFrozen;  // pure air (see isFrozenComposition2D())
+};
+extern void CalcChemicalComposition2D(FlowNode2D<FP,NUM_COMPONENTS>* CalcNode,
+                                      FlowNodeCold2D<FP,NUM_COMPONENTS>* CalcNodeCold,
+                                      ChemicalReactionsModel cr_model, void* CRM_data,
+                                      NodeComposition2D* c);
+extern void CalcMixtureProperties2D(FlowNode2D<FP,NUM_COMPONENTS>* CalcNodes,
+                                    NodeComposition2D* c, int cnt,
+                                    void* CRM_data, unsigned int* prop_hint = NULL);
 int SetNonReflectedBC(UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >* OutputMatrix2D,
                       FP beta_nrbc,
                       ofstream* f_stream);
@@ -188,14 +283,16 @@ UArray<FP>* GetWallFrictionVelocityArray2D(ComputationalMatrix2D* pJ,
 
 #ifdef _PARALLEL_RECALC_Y_PLUS_
 void ParallelRecalc_y_plus(ComputationalMatrix2D* pJ, 
+                           ColdMatrix2D* pCold,
                            UArray< XY<int> >* WallNodes,
                            UArray<FP>* WallFrictionVelocity2D,
-                           FP x0);
+                           FP x0, FP y0,
+                           NodeSpanList2D<FP,NUM_COMPONENTS>* Spans=NULL);
 #else
-extern void Recalc_y_plus(ComputationalMatrix2D* pJ, UArray< XY<int> >* WallNodes);
+extern void Recalc_y_plus(ComputationalMatrix2D* pJ, ColdMatrix2D* pCold, UArray< XY<int> >* WallNodes);
 #endif //_PARALLEL_RECALC_Y_PLUS_
  
-extern void SetMinDistanceToWall2D(ComputationalMatrix2D* pJ2D,UArray< XY<int> >* WallNodes2D, FP x0=0.0);
+extern void SetMinDistanceToWall2D(ComputationalMatrix2D* pJ2D,ColdMatrix2D* pCold2D,UArray< XY<int> >* WallNodes2D, FP x0=0.0);
 extern int BuildMesh(int mode);
 extern void InitSharedData(InputData*, void*
 #ifdef _MPI
@@ -207,7 +304,7 @@ extern void DEEPS2D_Run(ofstream* o_stream
 #ifdef _MPI
                         ,UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >*     pJ,
                         UMatrix2D< FlowNodeCore2D<FP,NUM_COMPONENTS> >* pC,
-                        int rank , int last_rank, FP x0
+                        int rank , int last_rank, FP x0, FP y0
 #endif // _MPI
                         );
 
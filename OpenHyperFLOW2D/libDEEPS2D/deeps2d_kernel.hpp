@@ -0,0 +1,840 @@
+/*******************************************************************************
+*   OpenHyperFLOW2D                                                            *
+*                                                                              *
+*   Transient, Density based Effective Explicit Parallel Solver (T-DEEPS2D)    *
+*                                                                              *
+*   Version  1.0.3                                                             *
+*   Copyright (C)  1995-2016 by Serge A. Suchkov                               *
+*   Copyright policy: LGPL V3                                                  *
+*   http://github.com/sergeas67/openhyperflow2d                                *
+*                                                                              *
+*   DEEPS2D sweep kernels (templated on flow field storage).                   *
+*                                                                              *
+*  last update: 07/04/2016                                                     *
+********************************************************************************/
+#ifndef _deeps2d_kernel_hpp_
+#define _deeps2d_kernel_hpp_
+
+#ifndef __ICC
+#include <malloc.h>
+#endif //__ICC
+
+#include "libOpenHyperFLOW2D/hyper_flow_field_soa.hpp"
+#include "libOpenHyperFLOW2D/hyper_flow_bc_mask.hpp"
+#include "libOpenHyperFLOW2D/hyper_flow_node_span.hpp"
+#include "libDEEPS2D/deeps2d_simd.hpp"
+
+#ifndef _MPI
+#ifndef _CACHE_LINE_SIZE
+#define _CACHE_LINE_SIZE 64
+#endif // _CACHE_LINE_SIZE
+
+// Residuals and time step of one field column (OpenMP/single thread version),
+// with tiled sweep - of column part in one row of tiles.
+// Column (part) is swept by one thread only and record is padded to cache line,
+// so threads never write to shared cache lines.
+struct
+#ifdef __ICC
+__declspec(align(_CACHE_LINE_SIZE))
+#else
+__attribute__ ((aligned (_CACHE_LINE_SIZE)))
+#endif //__ICC
+ColumnResidual2D {
+       FP           RMS[6+NUM_COMPONENTS];     // sum residual
+       FP           sumDiv[6+NUM_COMPONENTS];  // sum div params (isAlternateRMS)
+       FP           DD_max[6+NUM_COMPONENTS];  // max residual
+       unsigned int iRMS[6+NUM_COMPONENTS];    // num involved nodes
+       int          i_c[6+NUM_COMPONENTS];     // max residual x-coord (field column)
+       int          j_c[6+NUM_COMPONENTS];     // max residual y-coord
+       FP           dt_min;                    // minimal time step
+};
+
+// Inlined into DEEPS2D_Run() (setjmp() of ___try), so no address-taken locals here (-Wclobbered)
+inline ColumnResidual2D* NewColumnResidual2D(int n) {
+#ifdef __ICC
+    return (ColumnResidual2D*)_mm_malloc(sizeof(ColumnResidual2D)*n,_CACHE_LINE_SIZE);
+#else
+    return (ColumnResidual2D*)memalign(_CACHE_LINE_SIZE,sizeof(ColumnResidual2D)*n);
+#endif //__ICC
+}
+
+inline void DeleteColumnResidual2D(ColumnResidual2D* r) {
+#ifdef __ICC
+    _mm_free(r);
+#else
+    free(r);
+#endif //__ICC
+}
+
+inline void ClearColumnResidual2D(ColumnResidual2D* r) {
+    for (int k=0;k<6+NUM_COMPONENTS;k++ ) {
+         r->RMS[k]    = r->sumDiv[k] = r->DD_max[k] = 0.;
+         r->iRMS[k]   = 0;
+         r->i_c[k]    = r->j_c[k] = 0;
+    }
+    r->dt_min = 1.;
+}
+
+// r += r1 (r1 - next columns), on equal max residual node of r is kept
+inline void AddColumnResidual2D(ColumnResidual2D* r, const ColumnResidual2D* r1) {
+    for (int k=0;k<6+NUM_COMPONENTS;k++ ) {
+         r->RMS[k]    += r1->RMS[k];
+         r->sumDiv[k] += r1->sumDiv[k];
+         r->iRMS[k]   += r1->iRMS[k];
+         if(r1->DD_max[k] > r->DD_max[k]) {
+            r->DD_max[k] = r1->DD_max[k];
+            r->i_c[k]    = r1->i_c[k];
+            r->j_c[k]    = r1->j_c[k];
+         }
+    }
+    r->dt_min = min(r->dt_min,r1->dt_min);
+}
+
+// Pairwise (tree) reduction of columns 0...n-1 into r[0].
+// Order of additions depends on n only, so sums are the same
+// for any number of threads and subdomains.
+inline void ReduceColumnResidual2D(ColumnResidual2D* r, int n) {
+    for(int step=1;step<n;step*=2) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if(n/step > 256)
+#endif //_OPENMP
+        for(int c=0;c<n-step;c+=2*step)
+            AddColumnResidual2D(r+c,r+c+step);
+    }
+}
+
+// Minimal dt of columns i_start...i_end-1 in n_ty rows of tiles (n_col columns per row)
+inline FP ColumnDtMin2D(const ColumnResidual2D* r, int n_col, int n_ty, int i_start, int i_end) {
+    FP dt_min = 1.;
+    for(int ty=0;ty<n_ty;ty++)
+        for(int c=i_start;c<i_end;c++)
+            dt_min = min(dt_min,r[ty*n_col+c].dt_min);
+    return dt_min;
+}
+#endif // _MPI
+
+// Sweep parameters (per subdomain)
+struct SweepParam2D {
+       FP   dt;
+       FP   dtdx;
+       FP   dtdy;
+       FP   dxx;
+       FP   dyy;
+       FP   dx_1;                 // 1/dx
+       FP   dy_1;                 // 1/dy
+       FP   beta_Scenario_Val;
+       FP   CFL_Scenario_Val;
+       int  StartXLocal;          // first local column
+       int  MaxXLocal;            // last local column + 1
+       int  StartYLocal;          // first row of sweep
+       int  MaxYLocal;            // last row of sweep + 1
+       long x_offset;             // first subdomain column in field
+       long col_offset;           // first subdomain column in node spans
+       int  iter;                 // global iteration number
+       int  simd;                 // SIMDLevel of interior node kernel (SIMD_NONE - scalar only)
+       int  batch_fill;           // 1 - deferred viscous fluxes and properties for runs of plain gas nodes
+       unsigned int prop_hint;    // last interval of mixture property tables (TableSet)
+       BCMask2D<NUM_COMPONENTS>*          bc;    // BC masks of field nodes (bc[n])
+       FlowNodeCold2D<FP,NUM_COMPONENTS>* cold;  // cold side-table of field nodes (cold[n])
+       NodeSpanList2D<FP,NUM_COMPONENTS>* spans; // active node spans
+#ifdef _MPI
+       Var_pack* DD_max;          // this rank residuals
+       int       rank;
+       FP        x0;              // x, y of first node of local field of rank
+       FP        y0;
+#else
+       ColumnResidual2D* res;     // residuals of field columns (res[i+col_offset]) of sweep rows
+#endif // _MPI
+};
+
+extern int                     isAlternateRMS;
+extern int                     TurbStartIter;
+extern int                     TurbExtModel;
+extern int                     isTurbulenceReset;
+extern int                     turb_mod_name_index;
+extern int                     err_i, err_j;
+extern FP                      beta0;
+extern FP                      nrbc_beta0;
+extern FP                      CFL;
+extern FP                      SigW,SigF;
+
+extern void ComputationalUnstability2D(ofstream* f_stream,
+                                       FlowNode2D<FP,NUM_COMPONENTS>* CurrentNode,
+                                       int i, int j, FP dt
+#ifdef _MPI
+                                       ,int rank, FP x0, FP y0
+#endif // _MPI
+                                       );
+
+// Equation after k: species equations (i2d_Yfu...i2d_Ycp) are skipped if NC == 0
+template <int NC>
+inline int DEEPS2D_NextEq(int k) {
+    return (k == i2d_RhoE) ? 4+NUM_COMPONENTS-NC : k+1;
+}
+
+// Stage 1 for one internal gas node (scalar kernel)
+// FT      - flow type (FT_FLAT, FT_AXISYMMETRIC)
+// TurbEq  - 1 if k-eps or Spalart-Allmaras equations is solved, else 0
+// NC      - number of solved species equations (0 or NUM_COMPONENTS)
+// k_start - first equation (4+NUM_COMPONENTS - turbulence equations only)
+template <class F, FlowType FT, int TurbEq, int NC>
+inline void DEEPS2D_Stage1Node(F& f, SweepParam2D* sp, int i, int j, int k_start = 0) {
+#ifdef __ICC
+    __declspec(align(_ALIGN)) FP   beta;
+    __declspec(align(_ALIGN)) FP   _beta;
+    __declspec(align(_ALIGN)) FP   dXX;
+    __declspec(align(_ALIGN)) FP   dYY;
+    __declspec(align(_ALIGN)) FP   n_n;
+    __declspec(align(_ALIGN)) FP   m_m;
+    __declspec(align(_ALIGN)) FP   n_n_1;
+    __declspec(align(_ALIGN)) FP   m_m_1;
+#else
+    FP   beta   __attribute__ ((aligned (_ALIGN)));
+    FP   _beta  __attribute__ ((aligned (_ALIGN)));
+    FP   dXX    __attribute__ ((aligned (_ALIGN)));
+    FP   dYY    __attribute__ ((aligned (_ALIGN)));
+    FP   n_n    __attribute__ ((aligned (_ALIGN)));
+    FP   m_m    __attribute__ ((aligned (_ALIGN)));
+    FP   n_n_1  __attribute__ ((aligned (_ALIGN)));
+    FP   m_m_1  __attribute__ ((aligned (_ALIGN)));
+#endif //__ICC
+    const FP dt   = sp->dt;
+    const FP dtdx = sp->dtdx;
+    const FP dtdy = sp->dtdy;
+    const FP dxx  = sp->dxx;
+    const FP dyy  = sp->dyy;
+    unsigned int n1,n2,n3,n4;
+    int Num_Eq;
+    UStencil2D st;
+
+    const long n = f.Index(i+sp->x_offset,j);
+
+    err_i = i;
+    err_j = j;
+
+    const BCMask2D<NUM_COMPONENTS>* bc = sp->bc + n;
+
+    n1=f.idXl(n);
+    n2=f.idXr(n);
+    n3=f.idYu(n);
+    n4=f.idYd(n);
+
+    f.Stencil(n,&st);
+
+    const long nL = st.L;  // neast
+    const long nR = st.R;  // nodes
+    const long nU = st.U;  // indexes
+    const long nD = st.D;
+
+    n_n = max(n1+n2,1);
+    m_m = max(n3+n4,1);
+
+    n_n_1 = 1./n_n;
+    m_m_1 = 1./m_m;
+
+    Num_Eq = TurbEq ? bc->NumEq : 4+NUM_COMPONENTS;
+
+    // Scan equation system ... k - number of equation
+    for (int k=k_start;k<Num_Eq;k=DEEPS2D_NextEq<NC>(k) ) {
+        // Precompiled BC flags for current equation
+        const int m = bc->Mask[k];
+
+        if ( m & BCM_UPDATE ) {
+
+            beta  = f.beta(n,k);
+            _beta = 1. - beta;
+
+            if ( m & BCM_dX ) {
+                dXX = f.dSdx(n,k) = (f.A(nR,k)-f.A(nL,k))*n_n_1;
+            } else {
+                f.S(n,k) = (f.S(nL,k)*n2+f.S(nR,k)*n1)*n_n_1;
+                dXX = f.dSdx(n,k) = 0.;
+            }
+            if ( m & BCM_dY ) {
+                dYY = f.dSdy(n,k) = (f.B(nU,k)-f.B(nD,k))*m_m_1;
+            } else {
+                f.S(n,k) =  (f.S(nU,k)*n3+f.S(nD,k)*n4)*m_m_1;
+                dYY = f.dSdy(n,k) = 0;
+            }
+            if ( m & BCM_d2X ) {
+                dXX = (f.dSdx(nL,k)+f.dSdx(nR,k))*0.5;
+            }
+            if ( m & BCM_d2Y ) {
+                dYY = (f.dSdy(nU,k)+f.dSdy(nD,k))*0.5;
+            }
+
+            if ( FT == FT_AXISYMMETRIC ) {
+                f.Snext(n,k) = f.S(n,k)*beta+_beta*(dxx*(f.S(nL,k)+f.S(nR,k))+dyy*(f.S(nU,k)+f.S(nD,k)))*0.5
+                             - (dtdx*dXX+dtdy*(dYY+f.F(n,k)/(j+1))) + (f.Src(n,k))*dt+f.SrcAdd(n,k);
+            } else {
+                f.Snext(n,k) = f.S(n,k)*beta+_beta*(dxx*(f.S(nL,k)+f.S(nR,k))+dyy*(f.S(nU,k)+f.S(nD,k)))*0.5
+                             - (dtdx*dXX+dtdy*dYY) + (f.Src(n,k))*dt+f.SrcAdd(n,k);
+            }
+        }
+    }
+}
+
+// Vectorized Stage 1 for interior nodes (SoA field of double only)
+template <class F>
+inline int DEEPS2D_Stage1SIMD(F&, SweepParam2D*, SIMDStage1Param*, int, long, int, int) {
+    return 0;
+}
+
+template <int a>
+inline int DEEPS2D_Stage1SIMD(FlowFieldSoA2D<double,a>& f, SweepParam2D* sp, SIMDStage1Param* p,
+                              int Num_Eq, long n, int j, int cnt) {
+    return DEEPS2D_Stage1Interior(sp->simd,f.GetArrays(),p,Num_Eq,n,j,cnt);
+}
+
+inline void DEEPS2D_InitSIMDParam(SIMDStage1Param* p, SweepParam2D* sp, FlowType ft, int nc) {
+    p->dt             = sp->dt;
+    p->dtdx           = sp->dtdx;
+    p->dtdy           = sp->dtdy;
+    p->dxx            = sp->dxx;
+    p->dyy            = sp->dyy;
+    p->isAxisymmetric = (ft == FT_AXISYMMETRIC);
+    p->NumY           = nc;
+}
+
+// Stage 1 for column i (rows sp->StartYLocal...sp->MaxYLocal-1).
+// Runs of interior nodes are processed by vectorized kernel (if sp->simd),
+// other nodes and tails of runs by scalar kernel, in the same j order.
+// Vectorized kernel solves flow and species equations only, turbulence
+// equations of its nodes (d2eps/dy2 of interior k-eps nodes) are solved
+// by scalar kernel after it, node by node in j order.
+template <class F, FlowType FT, int TurbEq, int NC>
+inline void DEEPS2D_Stage1Column(F& f, SweepParam2D* sp, SIMDStage1Param* p, int i) {
+    NodeSpan2D*     si     = NULL;
+    NodeSpan2D*     si_end = NULL;
+
+    if(sp->simd) {
+       si     = sp->spans->Begin(NST_INTERIOR,i+sp->col_offset);
+       si_end = sp->spans->End(NST_INTERIOR,i+sp->col_offset);
+    }
+    for (NodeSpan2D* s = sp->spans->Begin(NST_GAS,i+sp->col_offset);s<sp->spans->End(NST_GAS,i+sp->col_offset);s++ ) {
+    const int j_end = min((int)s->j_end,sp->MaxYLocal);
+    for (int j=max((int)s->j_start,sp->StartYLocal);j<j_end; ) {
+       while(si < si_end && (int)si->j_end <= j)
+             si++;
+       if(si < si_end && (int)si->j_start <= j) {
+          const long n      = f.Index(i+sp->x_offset,j);
+          const int  done   = DEEPS2D_Stage1SIMD(f,sp,p,4+NUM_COMPONENTS,n,j,min((int)si->j_end,j_end)-j);
+          if(done) {
+             if(TurbEq)
+                for (int jj=j;jj<j+done;jj++ )
+                     DEEPS2D_Stage1Node<F,FT,TurbEq,NC>(f,sp,i,jj,4+NUM_COMPONENTS);
+             err_i = i;
+             err_j = j+done-1;
+             j    += done;
+             continue;
+          }
+       }
+       DEEPS2D_Stage1Node<F,FT,TurbEq,NC>(f,sp,i,j);
+       j++;
+    }
+    }
+}
+
+// Stage 1: new time layer (Snext) for all internal gas nodes
+template <class F, FlowType FT, int TurbEq, int NC>
+void DEEPS2D_Stage1(F& f, SweepParam2D* sp) {
+    SIMDStage1Param p;
+
+    DEEPS2D_InitSIMDParam(&p,sp,FT,NC);
+    f.CheckRange(sp->StartXLocal+sp->x_offset,sp->MaxXLocal+sp->x_offset);
+
+    for (int i = sp->StartXLocal;i<sp->MaxXLocal;i++ )
+         DEEPS2D_Stage1Column<F,FT,TurbEq,NC>(f,sp,&p,i);
+}
+
+// Stage 2 for node n=(i,j): residuals, blending factor, new S and gradients
+// SM      - solver mode (SM_EULER, SM_NS)
+// BFF     - blending factor function
+// TurbEq  - 1 if k-eps or Spalart-Allmaras equations is solved, else 0
+template <class F, SolverMode SM, BlendingFactorFunction BFF, int TurbEq, int NC>
+inline void DEEPS2D_Stage2Node(F& f, SweepParam2D* sp, int i, int j, long n) {
+#ifdef __ICC
+    __declspec(align(_ALIGN)) FP   n_n;
+    __declspec(align(_ALIGN)) FP   m_m;
+    __declspec(align(_ALIGN)) FP   dx_1_n_n_1; // 1/(2*dx)
+    __declspec(align(_ALIGN)) FP   dy_1_m_m_1; // 1/(2*dy)
+    __declspec(align(_ALIGN)) FP   DD_local[FlowNode2D<FP,NUM_COMPONENTS>::NumEq];
+#else
+    FP   n_n    __attribute__ ((aligned (_ALIGN)));
+    FP   m_m    __attribute__ ((aligned (_ALIGN)));
+    FP   dx_1_n_n_1 __attribute__ ((aligned (_ALIGN))); // 1/(2*dx)
+    FP   dy_1_m_m_1 __attribute__ ((aligned (_ALIGN))); // 1/(2*dy)
+    FP   DD_local[FlowNode2D<FP,NUM_COMPONENTS>::NumEq] __attribute__ ((aligned (_ALIGN)));
+#endif //__ICC
+    const FP dx_1 = sp->dx_1;
+    const FP dy_1 = sp->dy_1;
+    unsigned int n1,n2,n3,n4;
+    int Num_Eq;
+    UStencil2D st;
+#ifdef _MPI
+    Var_pack* DD_max = sp->DD_max;
+#else
+    ColumnResidual2D* res = sp->res + i + sp->col_offset;
+#endif // _MPI
+
+    const BCMask2D<NUM_COMPONENTS>* bc = sp->bc + n;
+    FlowNode2D<FP,NUM_COMPONENTS>* CurrentNode = &f.Node(n);
+
+    n1=f.idXl(n);
+    n2=f.idXr(n);
+    n3=f.idYu(n);
+    n4=f.idYd(n);
+
+    f.Stencil(n,&st);
+
+    const long nL = st.L;
+    const long nR = st.R;
+    const long nU = st.U;
+    const long nD = st.D;
+
+    n_n = max(n1+n2,1);
+    m_m = max(n3+n4,1);
+
+    dx_1_n_n_1 = dx_1/n_n;
+    dy_1_m_m_1 = dy_1/m_m;
+
+    Num_Eq = TurbEq ? bc->NumEq : 4+NUM_COMPONENTS;
+
+    for (int k=0;k<Num_Eq;k=DEEPS2D_NextEq<NC>(k) ) {
+
+        const int m = bc->Mask[k];
+
+        if ( (m & BCM_RESIDUAL) &&
+              f.S(n,k) != 0. ) {
+
+              FP Tmp;
+              FP beta_min;
+              FP sqrt_RES = 0;
+              FP absDD    = 0.;
+
+              if(k == i2d_RhoU && k == i2d_RhoV ) {
+                  Tmp = max(fabs(f.S(n,i2d_RhoU)),fabs(f.S(n,i2d_RhoV)));// max Flux
+              } else {
+                 Tmp = f.S(n,k);
+              }
+
+              absDD       = f.Snext(n,k)-f.S(n,k);
+
+              if(fabs(Tmp) > 1.e-15) {
+                  DD_local[k] = fabs(absDD/Tmp);
+                  sqrt_RES    = sqrt(DD_local[k]);
+              } else {
+                  DD_local[k] = 1.0;
+              }
+
+              beta_min = min(beta0,sp->beta_Scenario_Val);
+
+              if(bc->Flags & BCN_NONREFLECTED) {
+                 beta_min = nrbc_beta0;
+              }
+
+              if( BFF == BFF_L) {
+              //LINEAR locally adopted blending factor function  (LLABFF)
+                f.beta(n,k) = min(beta_min,(beta_min*beta_min)/(beta_min+DD_local[k]));
+              } else if( BFF == BFF_LR) {
+              //LINEAR locally adopted blending factor function with relaxation (LLABFFR)
+                f.beta(n,k) = min((beta_min+f.beta(n,k))*0.5,(beta_min*beta_min)/(beta_min+DD_local[k]));
+              } else if( BFF == BFF_S) {
+                //SQUARE locally adopted blending factor function (SLABF)
+                f.beta(n,k) = min(beta_min,(beta_min*beta_min)/(beta_min+DD_local[k]*DD_local[k]));
+              } else if (BFF == BFF_SR) {
+                //SQUARE locally adopted blending factor function with relaxation (SLABFFR)
+                f.beta(n,k) = min((beta_min+f.beta(n,k))*0.5,(beta_min*beta_min)/(beta_min+DD_local[k]*DD_local[k]));
+              } else if( BFF == BFF_SQR) {
+              //SQRT() locally adopted blending factor function (SQRLABF) + most accurate & stable +
+                f.beta(n,k) = min(beta_min,(beta_min*beta_min)/(beta_min+sqrt_RES));
+              } else if( BFF == BFF_SQRR) {
+                f.beta(n,k) = min((beta_min+f.beta(n,k))*0.5,(beta_min*beta_min)/(beta_min+sqrt_RES));
+              }
+#ifdef _MPI
+              DD_max->DD[k].DD      = max(DD_max->DD[k].DD,DD_local[k]);
+
+              if (isAlternateRMS) {
+                  DD_max->DD[k].RMS    += absDD*absDD;
+                  DD_max->DD[k].sumDiv += Tmp*Tmp;
+              } else {
+                  DD_max->DD[k].RMS    += DD_local[k]*DD_local[k];
+                  DD_max->DD[k].iRMS++;
+              }
+
+                if (DD_max->DD[k].DD==DD_local[k] ) {
+                    DD_max->DD[k].i = i;
+                    DD_max->DD[k].j = j;
+                }
+#else
+              if (isAlternateRMS) {
+                   res->sumDiv[k] += Tmp*Tmp;
+                   res->RMS[k]    += absDD;
+               } else {
+                   res->RMS[k]    += DD_local[k]*DD_local[k];
+               }
+
+               res->iRMS[k]++;
+
+               res->DD_max[k] = max(res->DD_max[k],DD_local[k]);
+
+              if ( res->DD_max[k] == DD_local[k] ) {
+                   res->i_c[k] = i + (int)sp->col_offset;
+                   res->j_c[k] = j;
+              }
+#endif // _MPI
+              }
+
+              if ( m & BCM_COPY )
+                   f.S(n,k)   = f.Snext(n,k);
+    }
+
+    //CurrentNode->beta[i2d_RhoV] = CurrentNode->beta[i2d_RhoU] = max(CurrentNode->beta[i2d_RhoU],CurrentNode->beta[i2d_RhoV]);  // for symmetry keeping
+
+    if(SM == SM_NS) {
+
+        FP  rhoY_air_Right = f.S(nR,i2d_Rho);
+        FP  rhoY_air_Left  = f.S(nL,i2d_Rho);
+        FP  rhoY_air_Up    = f.S(nU,i2d_Rho);
+        FP  rhoY_air_Down  = f.S(nD,i2d_Rho);
+
+        CurrentNode->droYdx[NUM_COMPONENTS]=CurrentNode->droYdy[NUM_COMPONENTS]=0.;
+
+        for (int k=4;k<FlowNode2D<FP,NUM_COMPONENTS>::NumEq-2;k++ ) {
+            if ( !(bc->Flags & BCN_dYdx_NULL) ) {
+                CurrentNode->droYdx[k-4]=(f.S(nR,k)-f.S(nL,k))*dx_1_n_n_1;
+                rhoY_air_Right -= f.S(nR,k);
+                rhoY_air_Left  -= f.S(nL,k);
+            }
+            if ( !(bc->Flags & BCN_dYdy_NULL) ) {
+                  CurrentNode->droYdy[k-4]=(f.S(nU,k)-f.S(nD,k))*dy_1_m_m_1;
+                  rhoY_air_Up    -= f.S(nU,k);
+                  rhoY_air_Down  -= f.S(nD,k);
+            }
+        }
+
+        if ( !(bc->Flags & BCN_dYdx_NULL) ) {
+            CurrentNode->droYdx[NUM_COMPONENTS]=(rhoY_air_Right - rhoY_air_Left)*dx_1_n_n_1;
+        }
+
+        if ( !(bc->Flags & BCN_dYdy_NULL) ) {
+            CurrentNode->droYdy[NUM_COMPONENTS]=(rhoY_air_Up - rhoY_air_Down)*dy_1_m_m_1;
+        }
+
+        if (bc->Flags & BCN_WALL)  {
+            CurrentNode->dUdx=(f.U(nR)*n1-f.U(nL)*n2)*dx_1_n_n_1;
+            CurrentNode->dVdx=(f.V(nR)*n1-f.V(nL)*n2)*dx_1_n_n_1;
+
+            CurrentNode->dUdy=(f.U(nU)*n3-f.U(nD)*n4)*dy_1_m_m_1;
+            CurrentNode->dVdy=(f.V(nU)*n3-f.V(nD)*n4)*dy_1_m_m_1;
+
+            if(TurbEq && (bc->Flags & BCN_K_EPS)){
+              CurrentNode->dkdx   =(f.S(nR,i2d_k)*n1-f.S(nL,i2d_k)*n2)*dx_1_n_n_1/f.S(n,i2d_Rho);
+              CurrentNode->depsdx =(f.S(nR,i2d_eps)*n1-f.S(nL,i2d_eps)*n2)*dx_1_n_n_1/f.S(n,i2d_Rho);
+
+              CurrentNode->dkdy   =(f.S(nU,i2d_k)*n3-f.S(nD,i2d_k)*n4)*dy_1_m_m_1/f.S(n,i2d_Rho);
+              CurrentNode->depsdy =(f.S(nU,i2d_eps)*n3-f.S(nD,i2d_eps)*n4)*dy_1_m_m_1/f.S(n,i2d_Rho);
+            } else if (TurbEq && (bc->Flags & BCN_SA)) {
+                       turb_mod_name_index = 3;
+                       CurrentNode->dkdx   =(f.S(nR,i2d_k)*n1-f.S(nL,i2d_k)*n2)*dx_1_n_n_1/f.S(n,i2d_Rho);
+                       CurrentNode->dkdy   =(f.S(nU,i2d_k)*n3-f.S(nD,i2d_k)*n4)*dy_1_m_m_1/f.S(n,i2d_Rho);
+            }
+        } else {
+            CurrentNode->dUdx   =(f.U(nR)-f.U(nL))*dx_1_n_n_1;
+            CurrentNode->dVdx   =(f.V(nR)-f.V(nL))*dx_1_n_n_1;
+
+            CurrentNode->dUdy   =(f.U(nU)-f.U(nD))*dy_1_m_m_1;
+            CurrentNode->dVdy   =(f.V(nU)-f.V(nD))*dy_1_m_m_1;
+            if(TurbEq && (bc->Flags & BCN_K_EPS)){
+              CurrentNode->dkdx   =(f.S(nR,i2d_k)-f.S(nL,i2d_k))*dx_1_n_n_1/f.S(n,i2d_Rho);
+              CurrentNode->depsdx =(f.S(nR,i2d_eps)-f.S(nL,i2d_eps))*dx_1_n_n_1/f.S(n,i2d_Rho);
+
+              CurrentNode->dkdy   =(f.S(nU,i2d_k)-f.S(nD,i2d_k))*dy_1_m_m_1/f.S(n,i2d_Rho);
+              CurrentNode->depsdy =(f.S(nU,i2d_eps)-f.S(nD,i2d_eps))*dy_1_m_m_1/f.S(n,i2d_Rho);
+            } else if (TurbEq && (bc->Flags & BCN_SA)) {
+                       turb_mod_name_index = 3;
+                       CurrentNode->dkdx   =(f.S(nR,i2d_k)-f.S(nL,i2d_k))*dx_1_n_n_1/f.S(n,i2d_Rho);
+                       CurrentNode->dkdy   =(f.S(nU,i2d_k)-f.S(nD,i2d_k))*dy_1_m_m_1/f.S(n,i2d_Rho);
+            }
+        }
+
+        CurrentNode->dTdx=(f.Tg(nR)-f.Tg(nL))*dx_1_n_n_1;
+        CurrentNode->dTdy=(f.Tg(nU)-f.Tg(nD))*dy_1_m_m_1;
+    }
+
+    f.Store(n);
+}
+
+// Stage 2 for node n=(i,j) after FillNode2D(): unstability check, time step
+template <class F>
+inline void DEEPS2D_Stage2TimeStep(F& f, SweepParam2D* sp, ofstream* f_stream, int i, int j, long n) {
+#ifdef __ICC
+    __declspec(align(_ALIGN)) FP   AAA;
+    __declspec(align(_ALIGN)) FP   dt_min_local;
+#else
+    FP   AAA    __attribute__ ((aligned (_ALIGN)));
+    FP   dt_min_local __attribute__ ((aligned (_ALIGN)));
+#endif //__ICC
+    FlowNode2D<FP,NUM_COMPONENTS>* CurrentNode = &f.Node(n);
+
+    if( CurrentNode->Tg < 0. ) {
+        ComputationalUnstability2D(f_stream,CurrentNode,i,j,sp->dt
+#ifdef _MPI
+                                   ,sp->rank,sp->x0,sp->y0
+#endif // _MPI
+                                   );
+    }  else {
+            FP CFL_min      = min(CFL,sp->CFL_Scenario_Val);
+            AAA                 = sqrt(CurrentNode->k*CurrentNode->R*CurrentNode->Tg);
+            dt_min_local        = CFL_min*
+                                  min(dx/(AAA+fabs(CurrentNode->U)),dy/(AAA+fabs(CurrentNode->V)));
+#ifdef _MPI
+            sp->DD_max->dt_min = min(sp->DD_max->dt_min, dt_min_local);
+#else
+            ColumnResidual2D* res = sp->res + i + sp->col_offset;
+            res->dt_min = min(res->dt_min,dt_min_local);
+#endif // _MPI
+    }
+}
+
+// Stage 2 for node n=(i,j) after FillNode2D(): time step, chemistry
+template <class F>
+inline void DEEPS2D_Stage2Post(F& f, SweepParam2D* sp, ofstream* f_stream, int i, int j, long n) {
+    DEEPS2D_Stage2TimeStep(f,sp,f_stream,i,j,n);
+    if( f.Node(n).Tg >= 0. )
+        CalcChemicalReactions(&f.Node(n),&sp->cold[n],CRM_ZELDOVICH, (void*)(&chemical_reactions),&sp->prop_hint);
+    f.Load(n);
+}
+
+// Node can be filled by FlowNode2D::FillPlainNode2D()
+inline int DEEPS2D_isPlainNode(FlowNode2D<FP,NUM_COMPONENTS>* pn, const BCMask2D<NUM_COMPONENTS>* bc) {
+    return !(bc->Flags & BCN_WALL) &&
+           !(pn->CT & (CT_SOLID_2D | CT_U_CONST_2D | CT_V_CONST_2D | CT_WALL_LAW_2D | CT_WALL_NO_SLIP_2D)) &&
+           pn->S[i2d_Rho] != 0. && pn->k >= 1.;
+}
+
+// Stage 2 for plain node n=(i,j) of batched run after DEEPS2D_Stage2Node():
+// FillPlainNode2D(), time step and composition, i.e. all values seen by
+// gradients of node j+1 (U, V, Tg, S) are new as in FillNode2D() path
+template <class F, SolverMode SM>
+inline void DEEPS2D_Stage2Plain(F& f, SweepParam2D* sp, ofstream* f_stream, int i, int j, long n,
+                                NodeComposition2D* c) {
+    if(sp->iter < TurbStartIter)
+       f.Node(n).FillPlainNode2D(0,isTurbulenceReset,(TurbulenceExtendedModel)TurbExtModel,delta_bl,SM);
+    else
+       f.Node(n).FillPlainNode2D(1,0,(TurbulenceExtendedModel)TurbExtModel,delta_bl,SM);
+
+    // ComputationalUnstability2D() terminates run, so after time step Tg >= 0
+    DEEPS2D_Stage2TimeStep(f,sp,f_stream,i,j,n);
+    CalcChemicalComposition2D(&f.Node(n),&sp->cold[n],CRM_ZELDOVICH,(void*)(&chemical_reactions),c);
+    f.LoadState(n);
+}
+
+// Batched rest of Stage 2 for plain nodes j0...j0+cnt-1 of column i after
+// DEEPS2D_Stage2Plain(): viscous fluxes (CP, lam, mu of FillNode2D() are
+// used) and then mixture properties for compositions c[0]...c[cnt-1]
+template <class F, SolverMode SM>
+inline void DEEPS2D_Stage2FillRun(F& f, SweepParam2D* sp, int i, int j0, int cnt, NodeComposition2D* c) {
+    if(cnt == 0)
+       return;
+
+    FlowNode2D<FP,NUM_COMPONENTS>* pn = &f.Node(f.Index(i+sp->x_offset,j0));
+
+    if(SM == SM_NS) {
+       if(sp->iter < TurbStartIter)
+          FlowNode2D<FP,NUM_COMPONENTS>::FillNodesViscous2D(pn,cnt,0,SigF);
+       else
+          FlowNode2D<FP,NUM_COMPONENTS>::FillNodesViscous2D(pn,cnt,1,SigF);
+    }
+
+    CalcMixtureProperties2D(pn,c,cnt,(void*)(&chemical_reactions),&sp->prop_hint);
+
+    for (int j=j0;j<j0+cnt;j++ )
+         f.Load(f.Index(i+sp->x_offset,j));
+}
+
+// Stage 2 for column i (rows sp->StartYLocal...sp->MaxYLocal-1): residuals, blending factor,
+// new S, gradients, FillNode2D() and chemistry.
+// With sp->batch_fill plain gas nodes are done in the same j order by
+// DEEPS2D_Stage2Plain() (gradients of next node see it as after FillNode2D()),
+// viscous fluxes and mixture properties of runs up to FILL_BATCH nodes are
+// deferred to DEEPS2D_Stage2FillRun(). Results are the same as without batch_fill.
+template <class F, SolverMode SM, BlendingFactorFunction BFF, int TurbEq, int NC>
+inline void DEEPS2D_Stage2Column(F& f, SweepParam2D* sp, ofstream* f_stream, int i) {
+    NodeComposition2D c[FILL_BATCH];
+
+#ifndef _MPI
+    ClearColumnResidual2D(sp->res + i + sp->col_offset);
+#endif // _MPI
+    for (NodeSpan2D* s = sp->spans->Begin(NST_FILL,i+sp->col_offset);s<sp->spans->End(NST_FILL,i+sp->col_offset);s++ ) {
+        const int j_end   = min((int)s->j_end,sp->MaxYLocal);
+        int       j_run   = (int)s->j_start; // first node of deferred plain run
+        int       run_cnt = 0;
+
+        for (int j=max((int)s->j_start,sp->StartYLocal);j<j_end;j++ ) {
+
+            const long n = f.Index(i+sp->x_offset,j);
+
+            const BCMask2D<NUM_COMPONENTS>* bc = sp->bc + n;
+
+            if (bc->Flags & BCN_ACTIVE) {
+                DEEPS2D_Stage2Node<F,SM,BFF,TurbEq,NC>(f,sp,i,j,n);
+
+                if(sp->batch_fill && DEEPS2D_isPlainNode(&f.Node(n),bc)) {
+                   if(run_cnt == 0)
+                      j_run = j;
+                   DEEPS2D_Stage2Plain<F,SM>(f,sp,f_stream,i,j,n,c+run_cnt);
+                   if(++run_cnt == FILL_BATCH) {
+                      DEEPS2D_Stage2FillRun<F,SM>(f,sp,i,j_run,run_cnt,c);
+                      run_cnt = 0;
+                   }
+                   continue;
+                }
+
+                DEEPS2D_Stage2FillRun<F,SM>(f,sp,i,j_run,run_cnt,c);
+                run_cnt = 0;
+
+                if(sp->iter < TurbStartIter) {
+                   f.Node(n).FillNode2D(0,isTurbulenceReset,SigW,SigF,(TurbulenceExtendedModel)TurbExtModel,delta_bl,SM);
+                } else {
+                   f.Node(n).FillNode2D(1,0,SigW,SigF,(TurbulenceExtendedModel)TurbExtModel,delta_bl,SM);
+                }
+                DEEPS2D_Stage2Post(f,sp,f_stream,i,j,n);
+            } else {
+                DEEPS2D_Stage2FillRun<F,SM>(f,sp,i,j_run,run_cnt,c);
+                run_cnt = 0;
+
+                if (bc->Flags & BCN_FC) {
+                    f.Node(n).FillNode2D(1,0,SigW,SigF,(TurbulenceExtendedModel)TurbExtModel,delta_bl,SM);
+                    f.Load(n);
+                }
+            }
+        }
+        DEEPS2D_Stage2FillRun<F,SM>(f,sp,i,j_run,run_cnt,c);
+    }
+}
+
+// Stage 2 for all subdomain columns
+template <class F, SolverMode SM, BlendingFactorFunction BFF, int TurbEq, int NC>
+void DEEPS2D_Stage2(F& f, SweepParam2D* sp, ofstream* f_stream) {
+    f.CheckRange(sp->StartXLocal+sp->x_offset,sp->MaxXLocal+sp->x_offset);
+
+    for (int i=sp->StartXLocal;i<sp->MaxXLocal;i++ )
+         DEEPS2D_Stage2Column<F,SM,BFF,TurbEq,NC>(f,sp,f_stream,i);
+}
+
+// Fused sweep: Stage 1 and Stage 2 in one pass with one column lag.
+// Stage 2 of column i-1 runs after Stage 1 of column i, so rolling window
+// of three columns (i-2...i) is touched and every node is read from memory
+// once per iteration. Data dependencies are the same as in two-pass scheme:
+// Stage 1 of column i sees old values of columns i-1 and i+1,
+// Stage 2 of column i-1 sees new values of column i-2 and Snext of column i.
+template <class F, FlowType FT, SolverMode SM, BlendingFactorFunction BFF, int TurbEq, int NC>
+void DEEPS2D_Fused(F& f, SweepParam2D* sp, ofstream* f_stream) {
+    SIMDStage1Param p;
+
+    DEEPS2D_InitSIMDParam(&p,sp,FT,NC);
+    f.CheckRange(sp->StartXLocal+sp->x_offset,sp->MaxXLocal+sp->x_offset);
+
+    for (int i=sp->StartXLocal;i<=sp->MaxXLocal;i++ ) {
+         if(i < sp->MaxXLocal)
+            DEEPS2D_Stage1Column<F,FT,TurbEq,NC>(f,sp,&p,i);
+         if(i > sp->StartXLocal)
+            DEEPS2D_Stage2Column<F,SM,BFF,TurbEq,NC>(f,sp,f_stream,i-1);
+    }
+}
+
+// DEEPS2D kernels for field type F, selected once per run
+template <class F>
+struct DEEPS2D_Kernel2D {
+       typedef void (*Stage1Func)(F&, SweepParam2D*);
+       typedef void (*Stage2Func)(F&, SweepParam2D*, ofstream*);
+
+       Stage1Func Stage1;
+       Stage2Func Stage2;
+       Stage2Func Fused;   // Stage 1 + Stage 2 in one pass
+
+       // nc - number of solved species equations (0 or NUM_COMPONENTS)
+       void Select(SolverMode sm, FlowType ft, BlendingFactorFunction bff, int turb_eq, int nc = NUM_COMPONENTS);
+};
+
+template <class F, SolverMode SM, int TurbEq, int NC>
+typename DEEPS2D_Kernel2D<F>::Stage2Func SelectStage2(BlendingFactorFunction bff) {
+    switch(bff) {
+      case BFF_L:    return DEEPS2D_Stage2<F,SM,BFF_L,TurbEq,NC>;
+      case BFF_LR:   return DEEPS2D_Stage2<F,SM,BFF_LR,TurbEq,NC>;
+      case BFF_S:    return DEEPS2D_Stage2<F,SM,BFF_S,TurbEq,NC>;
+      case BFF_SR:   return DEEPS2D_Stage2<F,SM,BFF_SR,TurbEq,NC>;
+      case BFF_SQR:  return DEEPS2D_Stage2<F,SM,BFF_SQR,TurbEq,NC>;
+      case BFF_SQRR: return DEEPS2D_Stage2<F,SM,BFF_SQRR,TurbEq,NC>;
+      default:       return DEEPS2D_Stage2<F,SM,BFF_MACH,TurbEq,NC>; // other BFF don't change beta here
+    }
+}
+
+template <class F, FlowType FT, SolverMode SM, int TurbEq, int NC>
+typename DEEPS2D_Kernel2D<F>::Stage2Func SelectFused(BlendingFactorFunction bff) {
+    switch(bff) {
+      case BFF_L:    return DEEPS2D_Fused<F,FT,SM,BFF_L,TurbEq,NC>;
+      case BFF_LR:   return DEEPS2D_Fused<F,FT,SM,BFF_LR,TurbEq,NC>;
+      case BFF_S:    return DEEPS2D_Fused<F,FT,SM,BFF_S,TurbEq,NC>;
+      case BFF_SR:   return DEEPS2D_Fused<F,FT,SM,BFF_SR,TurbEq,NC>;
+      case BFF_SQR:  return DEEPS2D_Fused<F,FT,SM,BFF_SQR,TurbEq,NC>;
+      case BFF_SQRR: return DEEPS2D_Fused<F,FT,SM,BFF_SQRR,TurbEq,NC>;
+      default:       return DEEPS2D_Fused<F,FT,SM,BFF_MACH,TurbEq,NC>;
+    }
+}
+
+template <class F, FlowType FT, int NC>
+typename DEEPS2D_Kernel2D<F>::Stage2Func SelectFused(SolverMode sm, BlendingFactorFunction bff, int turb_eq) {
+    if(sm == SM_NS) {
+       if(turb_eq)
+          return SelectFused<F,FT,SM_NS,1,NC>(bff);
+       else
+          return SelectFused<F,FT,SM_NS,0,NC>(bff);
+    }
+    return SelectFused<F,FT,SM_EULER,0,NC>(bff);
+}
+
+template <class F, FlowType FT, int NC>
+typename DEEPS2D_Kernel2D<F>::Stage1Func SelectStage1(int turb_eq) {
+    if(turb_eq)
+       return DEEPS2D_Stage1<F,FT,1,NC>;
+    return DEEPS2D_Stage1<F,FT,0,NC>;
+}
+
+template <class F, int NC>
+void SelectKernel2D(DEEPS2D_Kernel2D<F>* kernel, SolverMode sm, FlowType ft, BlendingFactorFunction bff, int turb_eq) {
+
+    if(ft == FT_AXISYMMETRIC)
+       kernel->Stage1 = SelectStage1<F,FT_AXISYMMETRIC,NC>(turb_eq);
+    else
+       kernel->Stage1 = SelectStage1<F,FT_FLAT,NC>(turb_eq);
+
+    if(sm == SM_NS) {
+       if(turb_eq)
+          kernel->Stage2 = SelectStage2<F,SM_NS,1,NC>(bff);
+       else
+          kernel->Stage2 = SelectStage2<F,SM_NS,0,NC>(bff);
+    } else {
+          kernel->Stage2 = SelectStage2<F,SM_EULER,0,NC>(bff);
+    }
+
+    if(ft == FT_AXISYMMETRIC)
+       kernel->Fused = SelectFused<F,FT_AXISYMMETRIC,NC>(sm,bff,turb_eq);
+    else
+       kernel->Fused = SelectFused<F,FT_FLAT,NC>(sm,bff,turb_eq);
+}
+
+template <class F>
+void DEEPS2D_Kernel2D<F>::Select(SolverMode sm, FlowType ft, BlendingFactorFunction bff, int turb_eq, int nc) {
+
+    if(sm != SM_NS)
+       turb_eq = 0;
+
+    if(nc == 0)
+       SelectKernel2D<F,0>(this,sm,ft,bff,turb_eq);
+    else
+       SelectKernel2D<F,NUM_COMPONENTS>(this,sm,ft,bff,turb_eq);
+}
+
+#endif // _deeps2d_kernel_hpp_
@@ -0,0 +1,108 @@
+/*******************************************************************************
+*   OpenHyperFLOW2D                                                            *
+*                                                                              *
+*   Transient, Density based Effective Explicit Parallel Solver (T-DEEPS2D)    *
+*                                                                              *
+*   Version  1.0.3                                                             *
+*   Copyright (C)  1995-2016 by Serge A. Suchkov                               *
+*   Copyright policy: LGPL V3                                                  *
+*   http://github.com/sergeas67/openhyperflow2d                                *
+*                                                                              *
+*   Thread pinning and NUMA placement of memory (Linux).                       *
+*                                                                              *
+*  last update: 07/04/2016                                                     *
+********************************************************************************/
+#include "libDEEPS2D/deeps2d_numa.hpp"
+
+#ifdef _NUMA_PLACEMENT_
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+// Memory policy syscalls are called directly (no libnuma dependence)
+#define _MPOL_PREFERRED 1
+#define _MPOL_MF_MOVE   (1<<1)
+#define _MPOL_F_NODE    (1<<0)
+#define _MPOL_F_ADDR    (1<<1)
+#define _MAX_NUMA_NODE  1024
+#endif // _NUMA_PLACEMENT_
+
+int GetCPUList2D(int* cpu, int max_cpu) {
+    int n = 0;
+#ifdef _NUMA_PLACEMENT_
+    cpu_set_t cpu_set;
+
+    CPU_ZERO(&cpu_set);
+    if(sched_getaffinity(0,sizeof(cpu_set),&cpu_set) != 0)
+       return 0;
+
+    for(int i=0;i<CPU_SETSIZE && n < max_cpu;i++)
+        if(CPU_ISSET(i,&cpu_set))
+           cpu[n++] = i;
+#endif // _NUMA_PLACEMENT_
+    return n;
+}
+
+int PinThread2D(int cpu) {
+#ifdef _NUMA_PLACEMENT_
+    cpu_set_t cpu_set;
+
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu,&cpu_set);
+    return sched_setaffinity(0,sizeof(cpu_set),&cpu_set) == 0 ? 0 : -1;
+#else
+    return -1;
+#endif // _NUMA_PLACEMENT_
+}
+
+int GetThreadNode2D(int* cpu) {
+#if defined(_NUMA_PLACEMENT_) && defined(SYS_getcpu)
+    unsigned int c = 0, node = 0;
+
+    if(syscall(SYS_getcpu,&c,&node,NULL) != 0)
+       return -1;
+    if(cpu)
+       *cpu = (int)c;
+    return (int)node;
+#else
+    if(cpu)
+       *cpu = -1;
+    return -1;
+#endif // _NUMA_PLACEMENT_
+}
+
+int MovePages2D(void* ptr, size_t len, int node) {
+#if defined(_NUMA_PLACEMENT_) && defined(SYS_mbind)
+    const unsigned long page = (unsigned long)sysconf(_SC_PAGESIZE);
+    const unsigned long bits = 8*sizeof(unsigned long);
+    unsigned long       start, end;
+    unsigned long       node_mask[_MAX_NUMA_NODE/(8*sizeof(unsigned long))] = {0};
+
+    if(node < 0 || node >= _MAX_NUMA_NODE || len == 0)
+       return -1;
+
+    start = ((unsigned long)ptr+page-1)/page*page;
+    end   = ((unsigned long)ptr+len)/page*page;
+    if(end <= start)
+       return 0;                   // no whole page in range
+
+    node_mask[node/bits] = 1UL << (node%bits);
+
+    return syscall(SYS_mbind,start,end-start,_MPOL_PREFERRED,
+                   node_mask,(unsigned long)_MAX_NUMA_NODE,_MPOL_MF_MOVE) == 0 ? 0 : -1;
+#else
+    return -1;
+#endif // _NUMA_PLACEMENT_
+}
+
+int GetPageNode2D(void* ptr) {
+#if defined(_NUMA_PLACEMENT_) && defined(SYS_get_mempolicy)
+    int node = -1;
+
+    if(syscall(SYS_get_mempolicy,&node,NULL,0UL,ptr,_MPOL_F_NODE|_MPOL_F_ADDR) != 0)
+       return -1;
+    return node;
+#else
+    return -1;
+#endif // _NUMA_PLACEMENT_
+}
@@ -0,0 +1,42 @@
+/*******************************************************************************
+*   OpenHyperFLOW2D                                                            *
+*                                                                              *
+*   Transient, Density based Effective Explicit Parallel Solver (T-DEEPS2D)    *
+*                                                                              *
+*   Version  1.0.3                                                             *
+*   Copyright (C)  1995-2016 by Serge A. Suchkov                               *
+*   Copyright policy: LGPL V3                                                  *
+*   http://github.com/sergeas67/openhyperflow2d                                *
+*                                                                              *
+*   Thread pinning and NUMA placement of memory (Linux).                       *
+*                                                                              *
+*  last update: 07/04/2016                                                     *
+********************************************************************************/
+#ifndef _deeps2d_numa_hpp_
+#define _deeps2d_numa_hpp_
+
+#include <stddef.h>
+
+#if defined(__linux__)
+#define _NUMA_PLACEMENT_
+#endif // __linux__
+
+// CPUs of affinity mask of calling thread (up to max_cpu), returns number of CPUs
+// (0 if not supported)
+extern int GetCPUList2D(int* cpu, int max_cpu);
+
+// Pin calling thread to CPU cpu, returns 0 if OK, -1 if not supported or failed
+extern int PinThread2D(int cpu);
+
+// NUMA node of calling thread (*cpu - current CPU if cpu != NULL), -1 - unknown
+extern int GetThreadNode2D(int* cpu = NULL);
+
+// Move present pages of [ptr, ptr+len) to NUMA node (only whole pages inside
+// range, so ranges of neighbor subdomains don't share pages), following page
+// faults in range prefer this node too. Returns 0 if OK, -1 if not supported or failed.
+extern int MovePages2D(void* ptr, size_t len, int node);
+
+// NUMA node of page with address ptr, -1 - unknown or page is not present
+extern int GetPageNode2D(void* ptr);
+
+#endif // _deeps2d_numa_hpp_
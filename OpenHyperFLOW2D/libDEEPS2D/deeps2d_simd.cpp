@@ -0,0 +1,190 @@
+/*******************************************************************************
+*   OpenHyperFLOW2D                                                            *
+*                                                                              *
+*   Transient, Density based Effective Explicit Parallel Solver (T-DEEPS2D)    *
+*                                                                              *
+*   Version  1.0.3                                                             *
+*   Copyright (C)  1995-2016 by Serge A. Suchkov                               *
+*   Copyright policy: LGPL V3                                                  *
+*   http://github.com/sergeas67/openhyperflow2d                                *
+*                                                                              *
+*   Explicitly vectorized (AVX2/AVX-512) DEEPS2D kernels for interior nodes.   *
+*                                                                              *
+*  last update: 07/04/2016                                                     *
+********************************************************************************/
+#include "libDEEPS2D/deeps2d_simd.hpp"
+
+#ifdef _SIMD_KERNEL_
+#include <immintrin.h>
+#endif // _SIMD_KERNEL_
+
+// Interior node: idXl=idXr=idYu=idYd=1 (n_n=m_m=2), flow and species
+// equations are updated with fluxes (no Dirichlet/Neumann conditions),
+// species equations are skipped if p->NumY == 0, turbulence equations
+// (Num_Eq = 4+NUM_COMPONENTS) are solved by scalar kernel.
+// Operation order is the same as in scalar DEEPS2D_Stage1Node(). This file
+// is compiled with $(EXACT_FP) (no FMA contraction, no fast-math reordering),
+// so results are identical to scalar kernel built without them too (OPTLEVEL=0).
+// With OPTLEVEL > 0 scalar kernel is built with -ffast-math -march=native and
+// results differ in last bits (see TestCases/check_precision.sh).
+
+#ifdef _SIMD_KERNEL_
+__attribute__ ((target ("avx2")))
+static int Stage1Interior_AVX2(FlowFieldArrays2D<double,NUM_COMPONENTS>* f,
+                               SIMDStage1Param* p,
+                               int Num_Eq, long n, int j, int cnt) {
+    const long    nY     = f->nY;
+    const int     m      = cnt & ~3;
+    const __m256d v_half = _mm256_set1_pd(0.5);
+    const __m256d v_one  = _mm256_set1_pd(1.0);
+    const __m256d v_dt   = _mm256_set1_pd(p->dt);
+    const __m256d v_dtdx = _mm256_set1_pd(p->dtdx);
+    const __m256d v_dtdy = _mm256_set1_pd(p->dtdy);
+    const __m256d v_dxx  = _mm256_set1_pd(p->dxx);
+    const __m256d v_dyy  = _mm256_set1_pd(p->dyy);
+
+    for (int k=0;k<Num_Eq;k = (k == i2d_RhoE) ? 4+NUM_COMPONENTS-p->NumY : k+1 ) {
+        const double* S      = f->S[k];
+        const double* A      = f->A[k];
+        const double* B      = f->B[k];
+        const double* F      = f->F[k];
+        const double* beta   = f->beta[k];
+        const double* Src    = f->Src[k];
+        const double* SrcAdd = f->SrcAdd[k];
+        double*       Snext  = f->Snext[k];
+        double*       dSdx   = f->dSdx[k];
+        double*       dSdy   = f->dSdy[k];
+
+        for (int l=0;l<m;l+=4 ) {
+            const long    c     = n+l;
+            const __m256d v_b   = _mm256_loadu_pd(beta+c);
+            const __m256d v_b_  = _mm256_sub_pd(v_one,v_b);
+            const __m256d v_dXX = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(A+c+nY),
+                                                              _mm256_loadu_pd(A+c-nY)),v_half);
+            __m256d       v_dYY = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(B+c+1),
+                                                              _mm256_loadu_pd(B+c-1)),v_half);
+            __m256d       v_S;
+            __m256d       v_D;
+
+            _mm256_storeu_pd(dSdx+c,v_dXX);
+            _mm256_storeu_pd(dSdy+c,v_dYY);
+
+            if (p->isAxisymmetric) {
+                const __m256d v_r = _mm256_set_pd(j+l+4,j+l+3,j+l+2,j+l+1);
+                v_dYY = _mm256_add_pd(v_dYY,_mm256_div_pd(_mm256_loadu_pd(F+c),v_r));
+            }
+            // dxx*(S[nL]+S[nR])+dyy*(S[nU]+S[nD])
+            v_D = _mm256_add_pd(_mm256_mul_pd(v_dxx,_mm256_add_pd(_mm256_loadu_pd(S+c-nY),
+                                                                  _mm256_loadu_pd(S+c+nY))),
+                                _mm256_mul_pd(v_dyy,_mm256_add_pd(_mm256_loadu_pd(S+c+1),
+                                                                  _mm256_loadu_pd(S+c-1))));
+            // S*beta+_beta*D*0.5
+            v_S = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(S+c),v_b),
+                                _mm256_mul_pd(_mm256_mul_pd(v_b_,v_D),v_half));
+            // - (dtdx*dXX+dtdy*dYY)
+            v_S = _mm256_sub_pd(v_S,_mm256_add_pd(_mm256_mul_pd(v_dtdx,v_dXX),
+                                                  _mm256_mul_pd(v_dtdy,v_dYY)));
+            // + Src*dt + SrcAdd
+            v_S = _mm256_add_pd(v_S,_mm256_mul_pd(_mm256_loadu_pd(Src+c),v_dt));
+            v_S = _mm256_add_pd(v_S,_mm256_loadu_pd(SrcAdd+c));
+
+            _mm256_storeu_pd(Snext+c,v_S);
+        }
+    }
+    return m;
+}
+
+__attribute__ ((target ("avx512f")))
+static int Stage1Interior_AVX512(FlowFieldArrays2D<double,NUM_COMPONENTS>* f,
+                                 SIMDStage1Param* p,
+                                 int Num_Eq, long n, int j, int cnt) {
+    const long    nY     = f->nY;
+    const int     m      = cnt & ~7;
+    const __m512d v_half = _mm512_set1_pd(0.5);
+    const __m512d v_one  = _mm512_set1_pd(1.0);
+    const __m512d v_dt   = _mm512_set1_pd(p->dt);
+    const __m512d v_dtdx = _mm512_set1_pd(p->dtdx);
+    const __m512d v_dtdy = _mm512_set1_pd(p->dtdy);
+    const __m512d v_dxx  = _mm512_set1_pd(p->dxx);
+    const __m512d v_dyy  = _mm512_set1_pd(p->dyy);
+
+    for (int k=0;k<Num_Eq;k = (k == i2d_RhoE) ? 4+NUM_COMPONENTS-p->NumY : k+1 ) {
+        const double* S      = f->S[k];
+        const double* A      = f->A[k];
+        const double* B      = f->B[k];
+        const double* F      = f->F[k];
+        const double* beta   = f->beta[k];
+        const double* Src    = f->Src[k];
+        const double* SrcAdd = f->SrcAdd[k];
+        double*       Snext  = f->Snext[k];
+        double*       dSdx   = f->dSdx[k];
+        double*       dSdy   = f->dSdy[k];
+
+        for (int l=0;l<m;l+=8 ) {
+            const long    c     = n+l;
+            const __m512d v_b   = _mm512_loadu_pd(beta+c);
+            const __m512d v_b_  = _mm512_sub_pd(v_one,v_b);
+            const __m512d v_dXX = _mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(A+c+nY),
+                                                              _mm512_loadu_pd(A+c-nY)),v_half);
+            __m512d       v_dYY = _mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(B+c+1),
+                                                              _mm512_loadu_pd(B+c-1)),v_half);
+            __m512d       v_S;
+            __m512d       v_D;
+
+            _mm512_storeu_pd(dSdx+c,v_dXX);
+            _mm512_storeu_pd(dSdy+c,v_dYY);
+
+            if (p->isAxisymmetric) {
+                const __m512d v_r = _mm512_set_pd(j+l+8,j+l+7,j+l+6,j+l+5,
+                                                  j+l+4,j+l+3,j+l+2,j+l+1);
+                v_dYY = _mm512_add_pd(v_dYY,_mm512_div_pd(_mm512_loadu_pd(F+c),v_r));
+            }
+            v_D = _mm512_add_pd(_mm512_mul_pd(v_dxx,_mm512_add_pd(_mm512_loadu_pd(S+c-nY),
+                                                                  _mm512_loadu_pd(S+c+nY))),
+                                _mm512_mul_pd(v_dyy,_mm512_add_pd(_mm512_loadu_pd(S+c+1),
+                                                                  _mm512_loadu_pd(S+c-1))));
+            v_S = _mm512_add_pd(_mm512_mul_pd(_mm512_loadu_pd(S+c),v_b),
+                                _mm512_mul_pd(_mm512_mul_pd(v_b_,v_D),v_half));
+            v_S = _mm512_sub_pd(v_S,_mm512_add_pd(_mm512_mul_pd(v_dtdx,v_dXX),
+                                                  _mm512_mul_pd(v_dtdy,v_dYY)));
+            v_S = _mm512_add_pd(v_S,_mm512_mul_pd(_mm512_loadu_pd(Src+c),v_dt));
+            v_S = _mm512_add_pd(v_S,_mm512_loadu_pd(SrcAdd+c));
+
+            _mm512_storeu_pd(Snext+c,v_S);
+        }
+    }
+    return m;
+}
+#endif // _SIMD_KERNEL_
+
+int GetSIMDLevel() {
+#ifdef _SIMD_KERNEL_
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f"))
+       return SIMD_AVX512;
+    if(__builtin_cpu_supports("avx2"))
+       return SIMD_AVX2;
+#endif // _SIMD_KERNEL_
+    return SIMD_NONE;
+}
+
+const char* GetSIMDName(int level) {
+    switch(level) {
+      case SIMD_AVX2:   return "AVX2";
+      case SIMD_AVX512: return "AVX-512";
+    }
+    return "none";
+}
+
+int DEEPS2D_Stage1Interior(int level,
+                           FlowFieldArrays2D<double,NUM_COMPONENTS>* f,
+                           SIMDStage1Param* p,
+                           int Num_Eq, long n, int j, int cnt) {
+#ifdef _SIMD_KERNEL_
+    switch(level) {
+      case SIMD_AVX512: return Stage1Interior_AVX512(f,p,Num_Eq,n,j,cnt);
+      case SIMD_AVX2:   return Stage1Interior_AVX2(f,p,Num_Eq,n,j,cnt);
+    }
+#endif // _SIMD_KERNEL_
+    return 0;
+}
@@ -0,0 +1,54 @@
+/*******************************************************************************
+*   OpenHyperFLOW2D                                                            *
+*                                                                              *
+*   Transient, Density based Effective Explicit Parallel Solver (T-DEEPS2D)    *
+*                                                                              *
+*   Version  1.0.3                                                             *
+*   Copyright (C)  1995-2016 by Serge A. Suchkov                               *
+*   Copyright policy: LGPL V3                                                  *
+*   http://github.com/sergeas67/openhyperflow2d                                *
+*                                                                              *
+*   Explicitly vectorized (AVX2/AVX-512) DEEPS2D kernels for interior nodes.   *
+*                                                                              *
+*  last update: 07/04/2016                                                     *
+********************************************************************************/
+#ifndef _deeps2d_simd_hpp_
+#define _deeps2d_simd_hpp_
+
+#include "libOpenHyperFLOW2D/hyper_flow_field_soa.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define _SIMD_KERNEL_
+#endif // x86 & GNU C++
+
+// Instruction set of vectorized kernels
+enum SIMDLevel {
+     SIMD_NONE = 0,  // scalar kernel only
+     SIMD_AVX2,      // 4 x double
+     SIMD_AVX512     // 8 x double
+};
+
+// Uniform parameters of interior node update
+struct SIMDStage1Param {
+       double dt;
+       double dtdx;
+       double dtdy;
+       double dxx;
+       double dyy;
+       int    isAxisymmetric;
+       int    NumY;           // number of solved species equations (0 or NUM_COMPONENTS)
+};
+
+// Detect best supported instruction set at runtime
+extern int         GetSIMDLevel();
+extern const char* GetSIMDName(int level);
+
+// Stage 1 for cnt interior nodes n...n+cnt-1 (j...j+cnt-1 in one column).
+// Returns number of processed nodes (multiple of vector width),
+// remaining nodes must be processed by scalar kernel.
+extern int DEEPS2D_Stage1Interior(int level,
+                                  FlowFieldArrays2D<double,NUM_COMPONENTS>* f,
+                                  SIMDStage1Param* p,
+                                  int Num_Eq, long n, int j, int cnt);
+
+#endif // _deeps2d_simd_hpp_
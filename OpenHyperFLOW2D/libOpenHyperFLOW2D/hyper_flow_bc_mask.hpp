@@ -0,0 +1,204 @@
+/*******************************************************************************
+*   OpenHyperFLOW2D                                                            *
+*                                                                              *
+*   Version  1.0.3                                                             *
+*   Copyright (C)  1995-2016 by Serge A. Suchkov                               *
+*   Copyright policy: LGPL V3                                                  *
+*   http://github.com/sergeas67/openhyperflow2d                                *
+*                                                                              *
+*   Precompiled per-node boundary condition masks for DEEPS2D solver kernels.  *
+*                                                                              *
+*   last update: 07/04/2016                                                    *
+*******************************************************************************/
+#ifndef  _hyper_flow_bc_mask_hpp
+#define  _hyper_flow_bc_mask_hpp
+
+#include "utl/umatrix2d.hpp"
+#include "libOpenHyperFLOW2D/hyper_flow_node.hpp"
+
+// Node flags (BCMask2D::Flags)
+enum BCNodeFlag2D {
+     BCN_ACTIVE       = 0x01,   // node is set, not solid and not fixed (NT_FC_2D)
+     BCN_FC           = 0x02,   // fixed condition node (NT_FC_2D)
+     BCN_NONREFLECTED = 0x04,   // non-reflected BC
+     BCN_WALL         = 0x08,   // wall (no-slip or wall law)
+     BCN_dYdx_NULL    = 0x10,   // dRhoY/dx = 0
+     BCN_dYdy_NULL    = 0x20,   // dRhoY/dy = 0
+     BCN_K_EPS        = 0x40,   // k-eps turbulence model
+     BCN_SA           = 0x80    // Spalart-Allmaras turbulence model
+};
+
+// Equation flags (BCMask2D::Mask[k])
+enum BCEqFlag2D {
+     BCM_UPDATE       = 0x01,   // calc new time layer for this equation
+     BCM_dX           = 0x02,   // dS/dx from fluxes (else dS/dx = 0)
+     BCM_dY           = 0x04,   // dS/dy from fluxes (else dS/dy = 0)
+     BCM_d2X          = 0x08,   // d2S/dx2 = 0
+     BCM_d2Y          = 0x10,   // d2S/dy2 = 0
+     BCM_RESIDUAL     = 0x20,   // residual & blending factor
+     BCM_COPY         = 0x40    // S = S(next)
+};
+
+// Compact BC record (one per node)
+template <int a>
+struct BCMask2D {
+       unsigned char Flags;           // BCNodeFlag2D
+       unsigned char NumEq;           // number of equations for this node
+       unsigned char Mask[6+a];       // BCEqFlag2D per equation
+};
+
+// Table of BC records, built from CT/TurbType of flow nodes.
+// Must be rebuilt if boundary conditions of nodes has been changed.
+template <class T, int a>
+class BCMaskTable2D {
+    UMatrix2D< FlowNode2D<T,a> >* pJ;
+    SolverMode                    sm;
+    long                          N;
+    BCMask2D<a>*                  pBC;
+
+public:
+
+    BCMaskTable2D(UMatrix2D< FlowNode2D<T,a> >* J, SolverMode SM);
+   ~BCMaskTable2D() {
+        delete[] pBC;
+    }
+
+    inline BCMask2D<a>*  GetMask(long n = 0)                     { return &pBC[n];}
+    inline size_t        GetTableSize()                          { return (size_t)N*sizeof(BCMask2D<a>);}
+
+    void                 BuildNode(long n);
+    void                 Build();
+    int                  isTurbulenceEq();   // 1 if k-eps or S-A nodes present
+};
+
+template <class T, int a>
+BCMaskTable2D<T,a>::BCMaskTable2D(UMatrix2D< FlowNode2D<T,a> >* J, SolverMode SM) {
+    pJ  = J;
+    sm  = SM;
+    N   = (long)pJ->GetX()*pJ->GetY();
+    pBC = new BCMask2D<a>[N];
+    Build();
+}
+
+template <class T, int a>
+void BCMaskTable2D<T,a>::Build() {
+    for(long n=0;n<N;n++)
+        BuildNode(n);
+}
+
+template <class T, int a>
+int BCMaskTable2D<T,a>::isTurbulenceEq() {
+    for(long n=0;n<N;n++)
+        if(pBC[n].Flags & (BCN_K_EPS | BCN_SA))
+           return 1;
+    return 0;
+}
+
+template <class T, int a>
+void BCMaskTable2D<T,a>::BuildNode(long n) {
+    FlowNode2D<T,a>* pn  = pJ->GetMatrixPtr()+n;
+    BCMask2D<a>*     bc  = &pBC[n];
+    int              AddEq;
+    int              isTurb;
+
+    bc->Flags = 0;
+    bc->NumEq = 0;
+
+    for (int k=0;k<6+a;k++ )
+         bc->Mask[k] = 0;
+
+    if (pn->isCond2D(CT_NODE_IS_SET_2D) &&
+        !pn->isCond2D(CT_SOLID_2D) &&
+        !pn->isCond2D(NT_FC_2D))
+        bc->Flags |= BCN_ACTIVE;
+    else if (pn->isCond2D(NT_FC_2D))
+        bc->Flags |= BCN_FC;
+
+    if (pn->isCond2D(CT_NONREFLECTED_2D))
+        bc->Flags |= BCN_NONREFLECTED;
+    if (pn->isCond2D(CT_WALL_NO_SLIP_2D) || pn->isCond2D(CT_WALL_LAW_2D))
+        bc->Flags |= BCN_WALL;
+    if (pn->isCond2D(CT_dYdx_NULL_2D))
+        bc->Flags |= BCN_dYdx_NULL;
+    if (pn->isCond2D(CT_dYdy_NULL_2D))
+        bc->Flags |= BCN_dYdy_NULL;
+    if (pn->isTurbulenceCond2D(TCT_k_eps_Model_2D))
+        bc->Flags |= BCN_K_EPS;
+    if (pn->isTurbulenceCond2D(TCT_Spalart_Allmaras_Model_2D))
+        bc->Flags |= BCN_SA;
+
+    if (pn->isTurbulenceCond2D(TCT_Prandtl_Model_2D))
+        AddEq = 2;
+    else if (pn->isTurbulenceCond2D(TCT_k_eps_Model_2D))
+        AddEq = 0;
+    else if (pn->isTurbulenceCond2D(TCT_Spalart_Allmaras_Model_2D))
+        AddEq = 1;
+    else
+        AddEq = 2;
+
+    bc->NumEq = (unsigned char)(FlowNode2D<T,a>::NumEq-AddEq);
+
+    isTurb = (sm == SM_NS && (bc->Flags & (BCN_K_EPS | BCN_SA)));
+
+    for (int k=0;k<bc->NumEq;k++ ) {
+        ulong c_flag, dx_flag, dy_flag, dx2_flag, dy2_flag;
+        ulong c2_flag = 0;
+        unsigned char m = 0;
+
+        c_flag = dx_flag = dy_flag = dx2_flag = dy2_flag = 0;
+
+        if ( k < 4 ) {
+            c_flag   = CT_Rho_CONST_2D     << k;
+            dx_flag  = CT_dRhodx_NULL_2D   << k;
+            dy_flag  = CT_dRhody_NULL_2D   << k;
+            dx2_flag = CT_d2Rhodx2_NULL_2D << k;
+            dy2_flag = CT_d2Rhody2_NULL_2D << k;
+            c2_flag  = c_flag;
+        } else if (k < (4+a)) {
+            c_flag   = CT_Y_CONST_2D;
+            dx_flag  = CT_dYdx_NULL_2D;
+            dy_flag  = CT_dYdy_NULL_2D;
+            dx2_flag = CT_d2Ydx2_NULL_2D;
+            dy2_flag = CT_d2Ydy2_NULL_2D;
+            c2_flag  = c_flag;
+        } else if (isTurb) {
+            if( k == i2d_k) {
+                c_flag   = TCT_k_CONST_2D     << (k-4-a);
+                dx_flag  = TCT_dkdx_NULL_2D   << (k-4-a);
+                dy_flag  = TCT_dkdy_NULL_2D   << (k-4-a);
+                dx2_flag = TCT_d2kdx2_NULL_2D << (k-4-a);
+                dy2_flag = TCT_d2kdy2_NULL_2D << (k-4-a);
+            } else if (k == i2d_eps) {
+                c_flag   = TCT_eps_CONST_2D     << (k-4-a);
+                dx_flag  = TCT_depsdx_NULL_2D   << (k-4-a);
+                dy_flag  = TCT_depsdy_NULL_2D   << (k-4-a);
+                dx2_flag = TCT_d2epsdx2_NULL_2D << (k-4-a);
+                dy2_flag = TCT_d2epsdy2_NULL_2D << (k-4-a);
+            }
+            c2_flag = TCT_k_CONST_2D << (k-4-a);
+        }
+
+        if (k<(4+a)) {
+            if ( !pn->isCond2D(c_flag) )   m |= BCM_UPDATE;
+            if ( !pn->isCond2D(dx_flag) )  m |= BCM_dX;
+            if ( !pn->isCond2D(dy_flag) )  m |= BCM_dY;
+            if (  pn->isCond2D(dx2_flag) ) m |= BCM_d2X;
+            if (  pn->isCond2D(dy2_flag) ) m |= BCM_d2Y;
+            if ( !pn->isCond2D(c2_flag) )  m |= BCM_COPY;
+        } else if (isTurb) {
+            if ( !pn->isTurbulenceCond2D(c_flag) )   m |= BCM_UPDATE;
+            if ( !pn->isTurbulenceCond2D(dx_flag) )  m |= BCM_dX;
+            if ( !pn->isTurbulenceCond2D(dy_flag) )  m |= BCM_dY;
+            if (  pn->isTurbulenceCond2D(dx2_flag) ) m |= BCM_d2X;
+            if (  pn->isTurbulenceCond2D(dy2_flag) ) m |= BCM_d2Y;
+            if ( !pn->isTurbulenceCond2D(c2_flag) )  m |= BCM_COPY;
+        }
+        // Residual test use CT bits for all equations
+        if ( !pn->isCond2D(c2_flag) )
+            m |= BCM_RESIDUAL;
+
+        bc->Mask[k] = m;
+    }
+}
+
+#endif // _hyper_flow_bc_mask_hpp
@@ -73,8 +73,70 @@ struct ChemicalReactionsModelData2D {
  Table* lam_cp;
  Table* mu_cp; 
  Table* Cp_cp; 
+ // Cp, lam, mu of fuel, OX, combustion products, air (see SetMixtureTables2D())
+ TableSet* Props;
 };
 
+// Species order in mixture property functions
+enum MixtureSpecies2D {
+     MS_FUEL = 0,
+     MS_OX,
+     MS_CP,
+     MS_AIR,
+     MS_NUM
+};
+
+// Build merged property tables (after all tables of model_data are loaded)
+inline void SetMixtureTables2D(ChemicalReactionsModelData2D* model_data) {
+    Table* t[3*MS_NUM] = {model_data->Cp_Fuel,  model_data->Cp_OX,  model_data->Cp_cp,  model_data->Cp_air,
+                          model_data->lam_Fuel, model_data->lam_OX, model_data->lam_cp, model_data->lam_air,
+                          model_data->mu_Fuel,  model_data->mu_OX,  model_data->mu_cp,  model_data->mu_air};
+    model_data->Props = new TableSet(t,3*MS_NUM);
+}
+
+// Mixture R, CP (and lam, mu if lam != NULL) at temperature T
+// for mass fractions Y[MS_FUEL]...Y[MS_AIR], one table search per call
+// (hint - last table interval of caller, see TableSet::GetVal()).
+inline void GetMixtureProperties2D(ChemicalReactionsModelData2D* model_data,
+                                   FP T, FP* Y, FP* R, FP* CP,
+                                   FP* lam = NULL, FP* mu = NULL,
+                                   unsigned int* hint = NULL) {
+    FP  v[3*MS_NUM];
+
+    model_data->Props->GetVal(T,v,lam ? 3*MS_NUM : MS_NUM,hint);
+
+    *R   = model_data->R_Fuel*Y[MS_FUEL]+
+           model_data->R_OX*Y[MS_OX]+
+           model_data->R_cp*Y[MS_CP]+
+           model_data->R_air*Y[MS_AIR];
+    *CP  = v[MS_FUEL]*Y[MS_FUEL]+v[MS_OX]*Y[MS_OX]+v[MS_CP]*Y[MS_CP]+v[MS_AIR]*Y[MS_AIR];
+    if( lam ) {
+        *lam = v[MS_NUM+MS_FUEL]*Y[MS_FUEL]+v[MS_NUM+MS_OX]*Y[MS_OX]+
+               v[MS_NUM+MS_CP]*Y[MS_CP]+v[MS_NUM+MS_AIR]*Y[MS_AIR];
+        *mu  = v[2*MS_NUM+MS_FUEL]*Y[MS_FUEL]+v[2*MS_NUM+MS_OX]*Y[MS_OX]+
+               v[2*MS_NUM+MS_CP]*Y[MS_CP]+v[2*MS_NUM+MS_AIR]*Y[MS_AIR];
+    }
+}
+
+// Properties of pure species s (Y[s]=1, other Y=0) at temperature T,
+// same values as GetMixtureProperties2D() but without other species tables.
+inline void GetSpeciesProperties2D(ChemicalReactionsModelData2D* model_data,
+                                   MixtureSpecies2D s, FP T, FP* R, FP* CP,
+                                   FP* lam = NULL, FP* mu = NULL,
+                                   unsigned int* hint = NULL) {
+    TableSet*    Props = model_data->Props;
+    unsigned int k     = Props->GetInterval(T,hint);
+    FP           Rs[MS_NUM] = {model_data->R_Fuel, model_data->R_OX,
+                               model_data->R_cp,   model_data->R_air};
+
+    *R  = Rs[s];
+    *CP = Props->GetVal(T,k,s);
+    if( lam ) {
+        *lam = Props->GetVal(T,k,MS_NUM+s);
+        *mu  = Props->GetVal(T,k,2*MS_NUM+s);
+    }
+}
+
 enum BoundState {
     BND_INACTIVE, BND_OK, BND_ERR
 };
@@ -0,0 +1,331 @@
+/*******************************************************************************
+*   OpenHyperFLOW2D                                                            *
+*                                                                              *
+*   Version  1.0.3                                                             *
+*   Copyright (C)  1995-2016 by Serge A. Suchkov                               *
+*   Copyright policy: LGPL V3                                                  *
+*   http://github.com/sergeas67/openhyperflow2d                                *
+*                                                                              *
+*   Structure-of-arrays (SoA) and array-of-structures (AoS) flow field views   *
+*   for DEEPS2D solver kernels.                                                *
+*                                                                              *
+*   last update: 07/04/2016                                                    *
+*******************************************************************************/
+#ifndef  _hyper_flow_field_soa_hpp
+#define  _hyper_flow_field_soa_hpp
+
+#include <stdlib.h>
+#include "utl/umatrix2d.hpp"
+#include "libOpenHyperFLOW2D/hyper_flow_node.hpp"
+
+#ifndef _SOA_ALIGN
+#define _SOA_ALIGN 64
+#endif // _SOA_ALIGN
+
+// Flow field storage type
+enum FieldStorageType {
+     FST_AOS = 0,    // array of FlowNode2D structures (default)
+     FST_SOA         // one contiguous aligned array per variable
+};
+
+// AoS view: direct access to FlowNode2D/FlowNodeCore2D matrix
+template <class T, int a>
+class FlowFieldAoS2D {
+    UMatrixView2D< FlowNode2D<T,a> >     vN;  // nodes
+    UMatrixView2D< FlowNodeCore2D<T,a> > vNC; // next time layer
+
+public:
+
+    FlowFieldAoS2D(UMatrix2D< FlowNode2D<T,a> >*     pJ,
+                   UMatrix2D< FlowNodeCore2D<T,a> >* pC):vN(pJ),vNC(pC) {;}
+
+    inline unsigned int     GetY()                              { return vN.GetY();}
+    inline long             Index(unsigned int i,unsigned int j){ return vN.Index(i,j);}
+    inline FlowNode2D<T,a>& Node(long n)                        { return vN[n];}
+
+    // Columns i_start <= i < i_end are swept (neighbors are checked by id flags)
+    inline void   CheckRange(unsigned int i_start, unsigned int i_end) {
+        vN.CheckRange(i_start,i_end,0,vN.GetY());
+        vNC.CheckRange(i_start,i_end,0,vNC.GetY());
+    }
+    inline void   Stencil(long n, UStencil2D* s) {
+        vN.Stencil(n,vN[n].idXl,vN[n].idXr,vN[n].idYu,vN[n].idYd,s);
+    }
+
+    inline ulong  isCond2D(long n, ulong ct)                    { return vN[n].isCond2D(ct);}
+    inline ulong  isTurbulenceCond2D(long n, ulong tct)         { return vN[n].isTurbulenceCond2D(tct);}
+    inline int    idXl(long n)                                  { return vN[n].idXl;}
+    inline int    idXr(long n)                                  { return vN[n].idXr;}
+    inline int    idYu(long n)                                  { return vN[n].idYu;}
+    inline int    idYd(long n)                                  { return vN[n].idYd;}
+
+    inline T&     S(long n, int k)                              { return vN[n].S[k];}
+    inline T&     Snext(long n, int k)                          { return vNC[n].S[k];}
+    inline T&     dSdx(long n, int k)                           { return vN[n].dSdx[k];}
+    inline T&     dSdy(long n, int k)                           { return vN[n].dSdy[k];}
+    inline T&     A(long n, int k)                              { return vN[n].A[k];}
+    inline T&     B(long n, int k)                              { return vN[n].B[k];}
+    inline T&     F(long n, int k)                              { return vN[n].F[k];}
+    inline T&     beta(long n, int k)                           { return vN[n].beta[k];}
+    inline T&     Src(long n, int k)                            { return vN[n].Src[k];}
+    inline T&     SrcAdd(long n, int k)                         { return vN[n].SrcAdd[k];}
+    inline T&     U(long n)                                     { return vN[n].U;}
+    inline T&     V(long n)                                     { return vN[n].V;}
+    inline T&     Tg(long n)                                    { return vN[n].Tg;}
+
+    // Node and field are the same memory
+    inline void   Store(long)                                   {;}
+    inline void   Load(long)                                    {;}
+    inline void   LoadState(long)                               {;}
+};
+
+// Raw SoA arrays (for explicitly vectorized kernels)
+template <class T, int a>
+struct FlowFieldArrays2D {
+       T**  S;
+       T**  Snext;
+       T**  dSdx;
+       T**  dSdy;
+       T**  A;
+       T**  B;
+       T**  F;
+       T**  beta;
+       T**  Src;
+       T**  SrcAdd;
+       long nY;
+};
+
+// SoA field: one aligned array per conserved variable/derived quantity.
+// FlowNode2D matrix remains the master copy for all non-kernel code;
+// Gather() copies nodes to arrays, Store()/Load() sync single node
+// around FillNode2D() and CalcChemicalReactions().
+// Arrays are staging copy of nodes: Stage 2 still works on FlowNode2D,
+// so every node is copied to arrays and back in each sweep.
+template <class T, int a>
+class FlowFieldSoA2D {
+    UMatrixView2D< FlowNode2D<T,a> > vN;  // master copy (same indexes as arrays)
+    unsigned int      nX,nY;
+    long              N;      // num nodes (padded)
+    void*             Pool;
+
+    T*   vS[6+a];
+    T*   vSnext[6+a];
+    T*   vdSdx[6+a];
+    T*   vdSdy[6+a];
+    T*   vA[6+a];
+    T*   vB[6+a];
+    T*   vF[6+a];
+    T*   vbeta[6+a];
+    T*   vSrc[6+a];
+    T*   vSrcAdd[6+a];
+    T*   vU;
+    T*   vV;
+    T*   vTg;
+    ulong*          vCT;
+    ulong*          vTurbType;
+    unsigned char*  vId;      // idXl | idXr<<1 | idYu<<2 | idYd<<3
+    FlowFieldArrays2D<T,a> Arrays;
+
+public:
+
+    FlowFieldSoA2D(UMatrix2D< FlowNode2D<T,a> >* pJ);
+   ~FlowFieldSoA2D();
+
+    inline unsigned int     GetX()                              { return nX;}
+    inline unsigned int     GetY()                              { return nY;}
+    inline long             Index(unsigned int i,unsigned int j){ return vN.Index(i,j);}
+    inline FlowNode2D<T,a>& Node(long n)                        { return vN[n];}
+    inline void*            GetPool()                           { return Pool;}
+    size_t                  GetPoolSize();
+    inline FlowFieldArrays2D<T,a>* GetArrays()               { return &Arrays;}
+
+    inline ulong  isCond2D(long n, ulong ct)                    { return ((vCT[n] & ct) == ct);}
+    inline ulong  isTurbulenceCond2D(long n, ulong tct)         { return ((vTurbType[n] & tct) == tct);}
+    inline int    idXl(long n)                                  { return  vId[n]     & 1;}
+    inline int    idXr(long n)                                  { return (vId[n]>>1) & 1;}
+    inline int    idYu(long n)                                  { return (vId[n]>>2) & 1;}
+    inline int    idYd(long n)                                  { return (vId[n]>>3) & 1;}
+
+    inline void   CheckRange(unsigned int i_start, unsigned int i_end) {
+        vN.CheckRange(i_start,i_end,0,nY);
+    }
+    inline void   Stencil(long n, UStencil2D* s) {
+        vN.Stencil(n,idXl(n),idXr(n),idYu(n),idYd(n),s);
+    }
+
+    inline T&     S(long n, int k)                              { return vS[k][n];}
+    inline T&     Snext(long n, int k)                          { return vSnext[k][n];}
+    inline T&     dSdx(long n, int k)                           { return vdSdx[k][n];}
+    inline T&     dSdy(long n, int k)                           { return vdSdy[k][n];}
+    inline T&     A(long n, int k)                              { return vA[k][n];}
+    inline T&     B(long n, int k)                              { return vB[k][n];}
+    inline T&     F(long n, int k)                              { return vF[k][n];}
+    inline T&     beta(long n, int k)                           { return vbeta[k][n];}
+    inline T&     Src(long n, int k)                            { return vSrc[k][n];}
+    inline T&     SrcAdd(long n, int k)                         { return vSrcAdd[k][n];}
+    inline T&     U(long n)                                     { return vU[n];}
+    inline T&     V(long n)                                     { return vV[n];}
+    inline T&     Tg(long n)                                    { return vTg[n];}
+
+    inline void   Store(long n);                  // arrays -> node (S,dSdx,dSdy,beta)
+    inline void   Load(long n);                   // node -> arrays (FillNode2D results)
+    inline void   LoadState(long n);              // node -> arrays (S,U,V,Tg for gradients of neighbors)
+    inline void   GatherNode(long n);             // node -> arrays (all fields)
+    void          Gather();                       // all nodes -> arrays
+    void          GatherColumn(unsigned int i);   // column i nodes -> arrays (halo)
+    void          GatherRow(unsigned int j,
+                            unsigned int i_start,
+                            unsigned int i_end);   // row j nodes of columns i_start...i_end-1 -> arrays (halo)
+    void          LoadSrcAdd(unsigned int i_start,
+                             unsigned int i_end);  // SrcAdd of wall nodes -> arrays
+};
+
+template <class T, int a>
+FlowFieldSoA2D<T,a>::FlowFieldSoA2D(UMatrix2D< FlowNode2D<T,a> >* pJ):vN(pJ) {
+    const int align_n = _SOA_ALIGN/sizeof(T);
+    int       k;
+    T*        p;
+
+    nX = pJ->GetX();
+    nY = pJ->GetY();
+    N  = ((long)nX*nY + align_n - 1)/align_n*align_n;
+    Pool = NULL;
+#ifdef __ICC
+    Pool = _mm_malloc(GetPoolSize(),_SOA_ALIGN);
+#else
+    if(posix_memalign(&Pool,_SOA_ALIGN,GetPoolSize()))
+       Pool = NULL;
+#endif //__ICC
+    if(Pool == NULL)
+       throw(this);
+
+    memset(Pool,0,GetPoolSize());
+
+    p = (T*)Pool;
+
+    for(k=0;k<6+a;k++) {
+        vS[k]      = p; p += N;
+        vSnext[k]  = p; p += N;
+        vdSdx[k]   = p; p += N;
+        vdSdy[k]   = p; p += N;
+        vA[k]      = p; p += N;
+        vB[k]      = p; p += N;
+        vF[k]      = p; p += N;
+        vbeta[k]   = p; p += N;
+        vSrc[k]    = p; p += N;
+        vSrcAdd[k] = p; p += N;
+    }
+
+    vU  = p; p += N;
+    vV  = p; p += N;
+    vTg = p; p += N;
+
+    vCT       = (ulong*)p;
+    vTurbType = vCT + N;
+    vId       = (unsigned char*)(vTurbType + N);
+
+    Arrays.S      = vS;
+    Arrays.Snext  = vSnext;
+    Arrays.dSdx   = vdSdx;
+    Arrays.dSdy   = vdSdy;
+    Arrays.A      = vA;
+    Arrays.B      = vB;
+    Arrays.F      = vF;
+    Arrays.beta   = vbeta;
+    Arrays.Src    = vSrc;
+    Arrays.SrcAdd = vSrcAdd;
+    Arrays.nY     = nY;
+}
+
+template <class T, int a>
+FlowFieldSoA2D<T,a>::~FlowFieldSoA2D() {
+#ifdef __ICC
+    _mm_free(Pool);
+#else
+    free(Pool);
+#endif //__ICC
+}
+
+template <class T, int a>
+size_t FlowFieldSoA2D<T,a>::GetPoolSize() {
+    return (size_t)N*(sizeof(T)*(10*(6+a)+3) + 2*sizeof(ulong) + sizeof(unsigned char));
+}
+
+template <class T, int a>
+inline void FlowFieldSoA2D<T,a>::Store(long n) {
+    FlowNode2D<T,a>* pn = &vN[n];
+    for(int k=0;k<6+a;k++) {
+        pn->S[k]    = vS[k][n];
+        pn->dSdx[k] = vdSdx[k][n];
+        pn->dSdy[k] = vdSdy[k][n];
+        pn->beta[k] = vbeta[k][n];
+    }
+}
+
+template <class T, int a>
+inline void FlowFieldSoA2D<T,a>::Load(long n) {
+    FlowNode2D<T,a>* pn = &vN[n];
+    for(int k=0;k<6+a;k++) {
+        vS[k][n]      = pn->S[k];
+        vA[k][n]      = pn->A[k];
+        vB[k][n]      = pn->B[k];
+        vF[k][n]      = pn->F[k];
+        vSrc[k][n]    = pn->Src[k];
+        vSrcAdd[k][n] = pn->SrcAdd[k];
+    }
+    vU[n]  = pn->U;
+    vV[n]  = pn->V;
+    vTg[n] = pn->Tg;
+}
+
+template <class T, int a>
+inline void FlowFieldSoA2D<T,a>::LoadState(long n) {
+    FlowNode2D<T,a>* pn = &vN[n];
+    for(int k=0;k<6+a;k++)
+        vS[k][n] = pn->S[k];
+    vU[n]  = pn->U;
+    vV[n]  = pn->V;
+    vTg[n] = pn->Tg;
+}
+
+template <class T, int a>
+inline void FlowFieldSoA2D<T,a>::GatherNode(long n) {
+    FlowNode2D<T,a>* pn = &vN[n];
+    Load(n);
+    for(int k=0;k<6+a;k++) {
+        vdSdx[k][n] = pn->dSdx[k];
+        vdSdy[k][n] = pn->dSdy[k];
+        vbeta[k][n] = pn->beta[k];
+    }
+    vCT[n]       = pn->CT;
+    vTurbType[n] = pn->TurbType;
+    vId[n]       = (unsigned char)((pn->idXl != 0)      | ((pn->idXr != 0) << 1) |
+                                  ((pn->idYu != 0) << 2) | ((pn->idYd != 0) << 3));
+}
+
+template <class T, int a>
+void FlowFieldSoA2D<T,a>::Gather() {
+    for(long n=0;n<(long)nX*nY;n++)
+        GatherNode(n);
+}
+
+template <class T, int a>
+void FlowFieldSoA2D<T,a>::GatherColumn(unsigned int i) {
+    for(long n=(long)i*nY;n<(long)(i+1)*nY;n++)
+        GatherNode(n);
+}
+
+template <class T, int a>
+void FlowFieldSoA2D<T,a>::GatherRow(unsigned int j, unsigned int i_start, unsigned int i_end) {
+    for(unsigned int i=i_start;i<i_end;i++)
+        GatherNode((long)i*nY+j);
+}
+
+template <class T, int a>
+void FlowFieldSoA2D<T,a>::LoadSrcAdd(unsigned int i_start, unsigned int i_end) {
+    for(long n=(long)i_start*nY;n<(long)i_end*nY;n++)
+        if((vCT[n] & CT_WALL_LAW_2D) || (vCT[n] & CT_WALL_NO_SLIP_2D))
+           vSrcAdd[i2d_RhoE][n] = vN[n].SrcAdd[i2d_RhoE];
+}
+
+#endif // _hyper_flow_field_soa_hpp
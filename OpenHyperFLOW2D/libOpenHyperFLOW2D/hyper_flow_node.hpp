@@ -134,7 +134,17 @@ struct FlowNodeCore2D {
     T dSdy[6+a];// dRho/dy, d(Rho*U)/dy,d(Rho*V)/dy, d(Rho*e)/dy, d(Rho*k)/dy, d(Rho*eps)/dy, d(Rho*Y1)/dy...d(Rho*.Yk)/dy;
 };
 
-// 2D-FlowNode class
+// Rarely used node data (cold side-table: matrix of the same layout as its computation area,
+// record of node (i,j) is (i,j) of side-table)
+template <class T, int a>
+struct FlowNodeCold2D {
+    T          time;                 // Global time (node (0,0) only).
+    T          Q_conv;               // Convective heat flux 
+    T          Tf;                   // ignition temperature
+    int        i_wall,j_wall;        // neast wall coordinates
+};
+
+// 2D-FlowNode class (hot record, used by solver kernel each iteration)
 template <class T, int a>
 class FlowNode2D: public  FlowNodeCore2D<T,a>,
                   public  FlowNodeTurbulence2D<T,a> {
@@ -149,12 +159,6 @@ public:
 #endif // _UNIFORM_MESH_
     T                dx,dy;       // dx, dy(dr)
     T                x,y;         // x, y(r)
-    int              ix,iy;       // i_x,i_y
-// Neighboring nodes
-    FlowNode2D<T,a>* UpNode;
-    FlowNode2D<T,a>* DownNode;
-    FlowNode2D<T,a>* LeftNode;
-    FlowNode2D<T,a>* RightNode;
 
     T          p;                    // pressure 
     int        idXl;                 // is left node present ? (0 or 1)
@@ -165,17 +169,11 @@ public:
     int        NGY;                  // dF/dy integer coeff. 0, 1 or -1
     //int        NodeID;               // Material ID (for solid Nodes)
     ulong      CT;                   // Condition type  (bit flags combination)
-    int        i_wall,j_wall;        // neast wall coordinates
     T          beta[6+a];            // superlocal blending factor (SLBF).
-    T          Q_conv;               // Convective heat flux 
-    T          time;                 // Global time.
     T          k,R,lam,mu,CP,Diff;   // Cp/Cv, gas constant (R/m), lam, mu, Cp, mu/Cp.
-    T          Tf;                   // ignition temperature
     T          A[6+a];               // A
     T          B[6+a];               // B
     T          F[6+a];               // F (only for axisymmetric flow)
-    T          RX[6+a];              // RX
-    T          RY[6+a];              // RY
     T          Src[6+a];             // Sources members
     T          SrcAdd[6+a];          // Additional virtual sources on the wall
     T          Tg,U,V,               // Temperature, U and V velocity components of gas
@@ -211,6 +209,10 @@ public:
     inline void   FillNode2D(int is_mu_t=0, int i=0, T sig_w=0.0, T sig_f=0.0, 
                              TurbulenceExtendedModel tem = TEM_k_eps_Std,
                              T delta = 0., SolverMode sm = SM_NS);
+    inline void   FillPlainNode2D(int is_mu_t=0, int i=0,
+                                  TurbulenceExtendedModel tem = TEM_k_eps_Std,
+                                  T delta = 0., SolverMode sm = SM_NS);
+    static void   FillNodesViscous2D(FlowNode2D<T,a>* fn, int cnt, int is_mu_t=0, T sig_f=0.0);
     inline ulong  isCond2D(ulong);
     inline FlowNode2D<T,a>& operator = (FlowNode2D<T,a>& fn);
     inline FlowNode2D<T,a>& operator = (FlowNodeCore2D<T,a>& fc);
@@ -390,6 +392,7 @@ inline void FlowNode2D<T,a>::FillNode2D(int is_mu_t,
     __declspec(align(_ALIGN)) T  sxx,txy,syy,qx,qy;   // viscous stresses & diffusion fluxes
     __declspec(align(_ALIGN)) T L, _mu, _lam, t00, G;
     __declspec(align(_ALIGN)) T Tmp1,Tmp2,Tmp3=0.;
+    __declspec(align(_ALIGN)) T RX[6+a],RY[6+a];        // viscous & diffusion fluxes
 #else
     unsigned int i __attribute__ ((aligned (_ALIGN)));
      // viscous stresses & diffusion fluxes
@@ -406,6 +409,8 @@ inline void FlowNode2D<T,a>::FillNode2D(int is_mu_t,
     T  Tmp1  __attribute__ ((aligned (_ALIGN)));
     T  Tmp2  __attribute__ ((aligned (_ALIGN)));
     T  Tmp3  __attribute__ ((aligned (_ALIGN))) =0.;
+    T  RX[6+a] __attribute__ ((aligned (_ALIGN)));     // viscous & diffusion fluxes
+    T  RY[6+a] __attribute__ ((aligned (_ALIGN)));
 #endif //__ICC
 
     k = CP/(CP-R);
@@ -598,6 +603,165 @@ inline void FlowNode2D<T,a>::FillNode2D(int is_mu_t,
             }
     }
 }
+#define FILL_BATCH 64 // nodes per FillNodesViscous2D() block (size of local arrays)
+
+// FillNode2D() of plain gas node (not solid, no wall, no U/V constant
+// conditions, S[i2d_Rho] != 0 and k >= 1 must be checked by caller)
+// without viscous and diffusion fluxes: U, V, turbulence model, p, Tg,
+// inviscid A, B, F. Operations are the same as in FillNode2D(), viscous
+// fluxes are added by FillNodesViscous2D() (NS).
+template <class T, int a>
+inline void FlowNode2D<T,a>::FillPlainNode2D(int is_mu_t,
+                                             int is_init,
+                                             TurbulenceExtendedModel tem,
+                                             T delta,
+                                             SolverMode sm) {
+    T  Tmp1;
+    T  Tmp3 = 0.;
+
+    k = CP/(CP-R);
+
+    U    = FlowNodeCore2D<T,a>::S[i2d_RhoU]/FlowNodeCore2D<T,a>::S[i2d_Rho];
+    V    = FlowNodeCore2D<T,a>::S[i2d_RhoV]/FlowNodeCore2D<T,a>::S[i2d_Rho];
+
+    if (sm == SM_NS) {
+        if(is_init  && FlowNodeTurbulence2D<T,a>::TurbType > 0) {
+            FlowNodeTurbulence2D<T,a>::mu_t = 5.0*mu;
+        } else if(is_init) {
+            FlowNodeTurbulence2D<T,a>::mu_t = FlowNodeTurbulence2D<T,a>::lam_t = 0.;
+        }
+        // old p is used by turbulence model
+        if(FlowNodeTurbulence2D<T,a>::TurbType > 0)
+           TurbModRANS2D(is_mu_t,is_init,tem,delta);
+    }
+
+    Tmp1   = FlowNodeCore2D<T,a>::S[i2d_Rho];
+
+    for(int i=0;i<a;i++) {
+        Tmp3+=Hu[i]*FlowNodeCore2D<T,a>::S[i+4];
+        Tmp1-= FlowNodeCore2D<T,a>::S[i+4];
+    }
+
+    Tmp3+=Hu[a]*Tmp1;
+
+    for(int i=0;i<NumEq;i++)
+        SrcAdd[i] = 0.;
+
+    p  = (k-1.)*(FlowNodeCore2D<T,a>::S[i2d_RhoE]-FlowNodeCore2D<T,a>::S[i2d_Rho]*(U*U+V*V)*0.5-Tmp3);
+
+    Tg = p/R/FlowNodeCore2D<T,a>::S[i2d_Rho];
+
+    A[i2d_Rho]  = FlowNodeCore2D<T,a>::S[i2d_RhoU];
+    A[i2d_RhoU] = p + FlowNodeCore2D<T,a>::S[i2d_RhoU]*U;
+    A[i2d_RhoV] = FlowNodeCore2D<T,a>::S[i2d_RhoV]*U;
+    A[i2d_RhoE] = (FlowNodeCore2D<T,a>::S[i2d_RhoE]+p)*U;
+
+    B[i2d_Rho]  = FlowNodeCore2D<T,a>::S[i2d_RhoV];
+    B[i2d_RhoU] = A[i2d_RhoV];
+    B[i2d_RhoV] = p + FlowNodeCore2D<T,a>::S[i2d_RhoV]*V;
+    B[i2d_RhoE] = (FlowNodeCore2D<T,a>::S[i2d_RhoE]+p)*V;
+
+    for(int i = 4; i < 4+a; i++) {
+        B[i]=FlowNodeCore2D<T,a>::S[i]*V;
+        A[i]=FlowNodeCore2D<T,a>::S[i]*U;
+    }
+
+    if( FT == FT_AXISYMMETRIC ) {
+        F[i2d_Rho]  = FT*B[i2d_Rho];
+        F[i2d_RhoU] = FT*A[i2d_RhoV];
+        F[i2d_RhoV] = FT*F[i2d_Rho]*V;
+        F[i2d_RhoE] = FT*B[i2d_RhoE];
+
+        for(int i = 4; i < 4+a;i++)
+            F[i]=FT*B[i];
+    }
+}
+
+// Viscous and diffusion fluxes (NS) of FillNode2D() for cnt consecutive
+// plain gas nodes fn[0]...fn[cnt-1] after FillPlainNode2D() (gradients of
+// nodes are computed, CP, lam, mu aren't changed after FillPlainNode2D()).
+// Each stage is done for all nodes of block in separate loop without
+// branches on node type.
+template <class T, int a>
+void FlowNode2D<T,a>::FillNodesViscous2D(FlowNode2D<T,a>* fn,
+                                         int cnt,
+                                         int is_mu_t,
+                                         T sig_f) {
+#ifdef __ICC
+    __declspec(align(_ALIGN)) T _mu[FILL_BATCH];
+    __declspec(align(_ALIGN)) T _lam[FILL_BATCH];
+    __declspec(align(_ALIGN)) T Tmp2[FILL_BATCH];   // L*dilatation
+#else
+    T  _mu[FILL_BATCH]   __attribute__ ((aligned (_ALIGN)));
+    T  _lam[FILL_BATCH]  __attribute__ ((aligned (_ALIGN)));
+    T  Tmp2[FILL_BATCH]  __attribute__ ((aligned (_ALIGN))); // L*dilatation
+#endif //__ICC
+
+    for(int l0=0;l0<cnt;l0+=FILL_BATCH) {
+
+        FlowNode2D<T,a>* pn = fn + l0;
+        const int        m  = min(FILL_BATCH,cnt-l0);
+
+        for(int l=0;l<m;l++) {
+            pn[l].lam_t = pn[l].mu_t*pn[l].CP;
+
+            if(is_mu_t) {
+                _mu[l]  = max(0,(pn[l].mu+pn[l].mu_t*sig_f));
+                _lam[l] = max(0,(pn[l].lam+pn[l].lam_t*sig_f));
+            } else {
+                _mu[l]  = pn[l].mu;
+                _lam[l] = pn[l].lam;
+            }
+
+            pn[l].Diff = _lam[l]/pn[l].CP;
+
+            if(FT == FT_AXISYMMETRIC)
+               Tmp2[l] = (2./3.)*_mu[l]*(pn[l].dUdx+pn[l].dVdy+FT*pn[l].V/pn[l].y);
+            else
+               Tmp2[l] = (2./3.)*_mu[l]*(pn[l].dUdx+pn[l].dVdy);
+        }
+
+        for(int l=0;l<m;l++) {
+            const T sxx  = 2.*_mu[l]*pn[l].dUdx - Tmp2[l];
+            const T syy  = 2.*_mu[l]*pn[l].dVdy - Tmp2[l];
+            const T txy  = _mu[l]*(pn[l].dUdy+pn[l].dVdx);
+            const T Diff = pn[l].Diff;
+            T       qx   = _lam[l]*pn[l].dTdx;
+            T       qy   = _lam[l]*pn[l].dTdy;
+
+            for(int i = 0; i < a+1; i++) {
+                qx += Diff*(pn[l].CP*pn[l].Tg+Hu[i])*pn[l].droYdx[i];
+                qy += Diff*(pn[l].CP*pn[l].Tg+Hu[i])*pn[l].droYdy[i];
+            }
+
+            pn[l].A[i2d_RhoU] -= sxx;
+            pn[l].A[i2d_RhoV] -= txy;
+            pn[l].A[i2d_RhoE] -= pn[l].U*sxx+pn[l].V*txy+qx;
+
+            pn[l].B[i2d_RhoU] -= txy;
+            pn[l].B[i2d_RhoV] -= syy;
+            pn[l].B[i2d_RhoE] -= pn[l].U*txy+pn[l].V*syy+qy;
+
+            for(int i = 4; i < 4+a; i++) {
+                pn[l].A[i] -= Diff*pn[l].droYdx[i-4];
+                pn[l].B[i] -= Diff*pn[l].droYdy[i-4];
+            }
+
+            if( FT == FT_AXISYMMETRIC ) {
+                const T t00 = 2*_mu[l]*pn[l].V/pn[l].y - Tmp2[l];
+                pn[l].F[i2d_RhoU] -= txy;
+                pn[l].F[i2d_RhoV] -= syy+t00;
+                pn[l].F[i2d_RhoE] -= pn[l].U*txy+pn[l].V*syy+qy;
+                for(int i = 4; i < 4+a;i++)
+                    pn[l].F[i] -= Diff*pn[l].droYdy[i-4];
+            } else {
+                for(int i=0;i<NumEq;i++)
+                    pn[l].F[i]=0.;
+            }
+        }
+    }
+}
+
 template <class T, int a>
 void  FlowNode2D<T,a>::TurbModRANS2D(int is_mu_t,
                                      int is_init,
@@ -606,8 +770,11 @@ void  FlowNode2D<T,a>::TurbModRANS2D(int is_mu_t,
 
  #ifdef __ICC
     __declspec(align(_ALIGN)) T l = max((FlowNodeTurbulence2D<T,a>::l_min),min(dy,dx)) * 0.41;
+    __declspec(align(_ALIGN)) T RX[6+a],RY[6+a];
  #else
    T l  __attribute__ ((aligned (_ALIGN))) = max((FlowNodeTurbulence2D<T,a>::l_min),min(dy,dx)) * 0.41;
+   T RX[6+a] __attribute__ ((aligned (_ALIGN)));
+   T RY[6+a] __attribute__ ((aligned (_ALIGN)));
  #endif // __ICC
     if(FlowNodeTurbulence2D<T,a>::isTurbulenceCond2D(TCT_Prandtl_Model_2D)) { 
  #ifdef __ICC
@@ -919,9 +1086,7 @@ void  FlowNode2D<T,a>::TurbModRANS2D(int is_mu_t,
         } else if (FlowNodeTurbulence2D<T,a>::isTurbulenceCond2D(TCT_k_omega_SST_Model_2D)) {
 
         } else if(FlowNodeTurbulence2D<T,a>::isTurbulenceCond2D(TCT_Integral_Model_2D) && mu != 0.0) {
-            FlowNodeTurbulence2D<T,a>::Re_local = FlowNodeTurbulence2D<T,a>::l_min*sqrt(FlowNodeCore2D<T,a>::S[i2d_RhoU]*FlowNodeCore2D<T,a>::S[i2d_RhoU]+
-                                                                                        FlowNodeCore2D<T,a>::S[i2d_RhoV]*FlowNodeCore2D<T,a>::S[i2d_RhoV]+
-                                                                                        1.e-30)/mu; 
+            // Integral model: local Re (l_min*|RhoU|/mu) is not used by solver
         } else if (FlowNodeTurbulence2D<T,a>::isTurbulenceCond2D(TCT_k_omega_SST_Model_2D) && !is_init) {
 
         } else if ( FlowNodeTurbulence2D<T,a>::isTurbulenceCond2D(TCT_Smagorinsky_Model_2D)) {
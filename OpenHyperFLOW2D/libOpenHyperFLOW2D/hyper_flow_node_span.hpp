@@ -0,0 +1,164 @@
+/*******************************************************************************
+*   OpenHyperFLOW2D                                                            *
+*                                                                              *
+*   Version  1.0.3                                                             *
+*   Copyright (C)  1995-2016 by Serge A. Suchkov                               *
+*   Copyright policy: LGPL V3                                                  *
+*   http://github.com/sergeas67/openhyperflow2d                                *
+*                                                                              *
+*   Run-length column spans of active nodes (work lists for solver passes).   *
+*                                                                              *
+*   last update: 07/04/2016                                                    *
+*******************************************************************************/
+#ifndef  _hyper_flow_node_span_hpp
+#define  _hyper_flow_node_span_hpp
+
+#include "utl/umatrix2d.hpp"
+#include "libOpenHyperFLOW2D/hyper_flow_node.hpp"
+#include "libOpenHyperFLOW2D/hyper_flow_bc_mask.hpp"
+
+// Node span types
+enum NodeSpanType2D {
+     NST_GAS = 0,        // internal gas nodes (set, not solid, not NT_FC_2D)
+     NST_FILL,           // internal gas nodes + fixed condition nodes
+     NST_FC,             // fixed condition nodes (NT_FC_2D)
+     NST_WALL,           // wall nodes (no-slip or wall law)
+     NST_NONREFLECTED,   // non-reflected BC nodes
+     NST_FLOW,           // all set, not solid nodes
+     NST_INTERIOR,       // plain gas nodes: no Dirichlet/Neumann BC of flow and species
+                         // equations, all 4 neighbors (built only with BC mask table,
+                         // spans have same NumEq, turbulence equations may have any BC)
+     NST_NUM
+};
+
+// Nodes j_start <= j < j_end in one column
+struct NodeSpan2D {
+       unsigned int j_start;
+       unsigned int j_end;
+};
+
+// Spans of each type, grouped by column:
+// spans of column i are Span[t][ColPtr[t][i]] ... Span[t][ColPtr[t][i+1]-1]
+template <class T, int a>
+class NodeSpanList2D {
+    UMatrix2D< FlowNode2D<T,a> >* pJ;
+    unsigned int                  nX,nY;
+    unsigned int*                 ColPtr[NST_NUM];
+    NodeSpan2D*                   Span[NST_NUM];
+    long                          NumNodes[NST_NUM];
+    BCMaskTable2D<T,a>*           pBCM;
+
+    int        isType(unsigned int i, unsigned int j, int t);
+    void       Clean();
+
+public:
+
+    NodeSpanList2D(UMatrix2D< FlowNode2D<T,a> >* J, BCMaskTable2D<T,a>* BCM = NULL);
+   ~NodeSpanList2D() {
+        Clean();
+    }
+
+    inline NodeSpan2D*   Begin(int t, unsigned int i)            { return Span[t]+ColPtr[t][i];}
+    inline NodeSpan2D*   End(int t, unsigned int i)              { return Span[t]+ColPtr[t][i+1];}
+    inline unsigned int  GetNumSpans(int t)                      { return ColPtr[t][nX];}
+    inline long          GetNumNodes(int t)                      { return NumNodes[t];}
+
+    void                 Build();
+};
+
+template <class T, int a>
+NodeSpanList2D<T,a>::NodeSpanList2D(UMatrix2D< FlowNode2D<T,a> >* J, BCMaskTable2D<T,a>* BCM) {
+    pJ   = J;
+    pBCM = BCM;
+    nX = pJ->GetX();
+    nY = pJ->GetY();
+    for(int t=0;t<NST_NUM;t++) {
+        ColPtr[t]   = NULL;
+        Span[t]     = NULL;
+        NumNodes[t] = 0;
+    }
+    Build();
+}
+
+template <class T, int a>
+void NodeSpanList2D<T,a>::Clean() {
+    for(int t=0;t<NST_NUM;t++) {
+        delete[] ColPtr[t];
+        delete[] Span[t];
+        ColPtr[t] = NULL;
+        Span[t]   = NULL;
+    }
+}
+
+// Returns 0 if node (i,j) is not of type t, else span class
+// (adjacent nodes of different classes are in separate spans)
+template <class T, int a>
+int NodeSpanList2D<T,a>::isType(unsigned int i, unsigned int j, int t) {
+    FlowNode2D<T,a>* pn = &pJ->GetValue(i,j);
+    int isFlow = pn->isCond2D(CT_NODE_IS_SET_2D) && !pn->isCond2D(CT_SOLID_2D);
+    switch(t) {
+      case NST_GAS:          return isFlow && !pn->isCond2D(NT_FC_2D);
+      case NST_FILL:         return isFlow || pn->isCond2D(NT_FC_2D);
+      case NST_FC:           return pn->isCond2D(NT_FC_2D) != 0;
+      case NST_WALL:         return !pn->isCond2D(CT_SOLID_2D) &&
+                                    (pn->isCond2D(CT_WALL_LAW_2D) || pn->isCond2D(CT_WALL_NO_SLIP_2D));
+      case NST_NONREFLECTED: return pn->isCond2D(CT_NONREFLECTED_2D) != 0;
+      case NST_FLOW:         return isFlow;
+      case NST_INTERIOR: {
+           if(pBCM == NULL || !pn->idXl || !pn->idXr || !pn->idYu || !pn->idYd)
+              return 0;
+           BCMask2D<a>* bc = pBCM->GetMask((long)i*nY+j);
+           if(!(bc->Flags & BCN_ACTIVE))
+              return 0;
+           for(int k=0;k<min((int)bc->NumEq,4+a);k++)
+               if((bc->Mask[k] & (BCM_UPDATE | BCM_dX | BCM_dY | BCM_d2X | BCM_d2Y)) !=
+                  (BCM_UPDATE | BCM_dX | BCM_dY))
+                  return 0;
+           return bc->NumEq;
+       }
+    }
+    return 0;
+}
+
+template <class T, int a>
+void NodeSpanList2D<T,a>::Build() {
+    Clean();
+    for(int t=0;t<NST_NUM;t++) {
+        unsigned int ns = 0;
+        // count spans
+        for(unsigned int i=0;i<nX;i++) {
+            int prev = 0;
+            for(unsigned int j=0;j<nY;j++) {
+                int cur = isType(i,j,t);
+                if(cur && cur != prev)
+                   ns++;
+                prev = cur;
+            }
+        }
+
+        ColPtr[t]   = new unsigned int[nX+1];
+        Span[t]     = new NodeSpan2D[ns+1];
+        NumNodes[t] = 0;
+        ns = 0;
+        // fill spans
+        for(unsigned int i=0;i<nX;i++) {
+            int prev = 0;
+            ColPtr[t][i] = ns;
+            for(unsigned int j=0;j<nY;j++) {
+                int cur = isType(i,j,t);
+                if(prev && cur != prev)
+                   Span[t][ns++].j_end = j;
+                if(cur && cur != prev)
+                   Span[t][ns].j_start = j;
+                if(cur)
+                   NumNodes[t]++;
+                prev = cur;
+            }
+            if(prev)
+               Span[t][ns++].j_end = nY;
+        }
+        ColPtr[t][nX] = ns;
+    }
+}
+
+#endif // _hyper_flow_node_span_hpp
@@ -11,6 +11,7 @@
 #include "libOpenHyperFLOW2D/hyper_flow_source.hpp"
 // <------------- 2D --------------->           
 Source2D::Source2D(ComputationalMatrix2D* f,
+                   ColdMatrix2D* c,
                    int s_x, int s_y, 
                    int e_x,int e_y, 
                    int c_idx,
@@ -18,7 +19,7 @@ Source2D::Source2D(ComputationalMatrix2D* f,
                    FP ms, 
                    FP t, 
                    FP t_f,
-                   int si):F(f),sx(s_x),sy(s_y),ex(e_x),ey(e_y),c_index(c_idx),Cp(cp),M_s0(ms),T(t),T_f(t_f),StartSrcIter(si) {}
+                   int si):F(f),C(c),sx(s_x),sy(s_y),ex(e_x),ey(e_y),c_index(c_idx),Cp(cp),M_s0(ms),T(t),T_f(t_f),StartSrcIter(si) {}
 
 Source2D::~Source2D() {
     ClearSource2D();
@@ -53,7 +54,7 @@ unsigned int x,y;
            
         F->GetValue(sx,sy).SrcAdd[i2d_Rho] =  0.;
         F->GetValue(sx,sy).Src[i2d_RhoU]   =  0;
-        F->GetValue(sx,sy).Tf             =  T_f;
+        C->GetValue(sx,sy).Tf             =  T_f;
         if(c_index < 4)
           F->GetValue(sx,sy).Src[c_index+4] =  F->GetValue(sx,sy).Src[i2d_Rho];
         F->GetValue(sx,sy).Src[i2d_RhoE]     =  Cp*T*F->GetValue(sx,sy).Src[i2d_Rho];
@@ -89,7 +90,7 @@ unsigned int x,y;
             }
                
             F->GetValue(x,y).SrcAdd[i2d_Rho] =  0.;
-            F->GetValue(x,y).Tf             =  T_f;
+            C->GetValue(x,y).Tf             =  T_f;
             F->GetValue(x,y).Src[i2d_RhoU]   =  0;
             F->GetValue(x,y).Src[i2d_RhoV]   =  0;
             F->GetValue(x,y).Src[c_index+4] =  F->GetValue(x,y).Src[i2d_Rho];
@@ -118,7 +119,7 @@ unsigned int x,y;
               }
 
             F->GetValue(x,y).SrcAdd[i2d_Rho] =  0.;
-            F->GetValue(x,y).Tf             =  T_f;
+            C->GetValue(x,y).Tf             =  T_f;
             F->GetValue(x,y).Src[i2d_RhoU]   =  0;
             F->GetValue(x,y).Src[i2d_RhoV]   =  0;
             F->GetValue(x,y).Src[c_index+4] =  F->GetValue(x,y).Src[i2d_Rho];
@@ -181,7 +182,7 @@ FP dF;
     return;
 }
 
-SourceList2D::SourceList2D(ComputationalMatrix2D* f, InputData* d) {
+SourceList2D::SourceList2D(ComputationalMatrix2D* f, ColdMatrix2D* c, InputData* d) {
 
     int     NumSrc;
     int     GasSource_SX;
@@ -208,6 +209,7 @@ SourceList2D::SourceList2D(ComputationalMatrix2D* f, InputData* d) {
     
     data =  d;
     F    =  f;
+    C    =  c;
 
     if(data) {
         Cp_cp   = data->GetTable((char*)"Cp_cp");
@@ -264,7 +266,7 @@ SourceList2D::SourceList2D(ComputationalMatrix2D* f, InputData* d) {
                data->GetMessageStream()->flush();
        }
        
-       TmpSrc = new Source2D(F,GasSource_SX,GasSource_SY,GasSource_EX,GasSource_EY,GasSourceIndex,Cp,Msrc,Tsrc,Tf_src,StartSrcIter);
+       TmpSrc = new Source2D(F,C,GasSource_SX,GasSource_SY,GasSource_EX,GasSource_EY,GasSourceIndex,Cp,Msrc,Tsrc,Tf_src,StartSrcIter);
        AddElement(&TmpSrc);
      }
    }
@@ -19,12 +19,16 @@
 #ifndef ComputationalMatrix2D
 #define ComputationalMatrix2D  UMatrix2D< FlowNode2D<FP,NUM_COMPONENTS> >
 #endif //ComputationalMatrix
+#ifndef ColdMatrix2D
+#define ColdMatrix2D  UMatrix2D< FlowNodeCold2D<FP,NUM_COMPONENTS> >
+#endif //ColdMatrix2D
 // <------------- 2D --------------->           
 
 class Source2D
 {
  
  ComputationalMatrix2D* F;                //   Reference to computational matrix
+ ColdMatrix2D*          C;                //   Reference to cold side-table of F
  int                    StartSrcIter;     //   Start source iteration
  int                    sx,sy,ex,ey;      //   Start and end points (in nodes)
  int                    c_index;          //   Component index
@@ -33,6 +37,7 @@ class Source2D
 public:
   
   Source2D(ComputationalMatrix2D* f,
+           ColdMatrix2D* c,
            int s_x, int s_y, 
            int e_x,int e_y, 
            int c_idx,
@@ -77,9 +82,10 @@ public:
 
 class SourceList2D : public UArray<Source2D*> {
     ComputationalMatrix2D* F;                //   Reference to computational matrix
+    ColdMatrix2D*   C;                       //   Reference to cold side-table of F
     InputData*      data;                    //   Reference to input data
 public:
-    SourceList2D(ComputationalMatrix2D*, InputData*);
+    SourceList2D(ComputationalMatrix2D*, ColdMatrix2D*, InputData*);
     ~SourceList2D() {};
 
 void  SetSources2D(int iter = 0);
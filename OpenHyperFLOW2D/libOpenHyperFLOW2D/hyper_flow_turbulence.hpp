@@ -117,7 +117,6 @@ public:
                                      // 0x04  - k-eps  model
     T          l_min;                // Minimal lenght from node to wall
     T          y_plus;               // y+=l_min * U_t/mu  
-    T          Re_local;             // Re local.
     T          mu_t,lam_t;           // turbulence viscosity and turbulence heat conductivity
     T          dkdx,dkdy,            // dk/dx, dk/dy
                depsdx,depsdy;        // deps/dx, deps/dy
@@ -1485,6 +1485,18 @@ char*       InputData::GetDataName() {
     return DataName;
 }
 
+int   InputData::CheckData(char* Name) {  // Check data object presence (without error message)
+    int      i;
+    Data*    D;
+
+    for ( i=0;i<(int)dataArray->GetNumElements();i++ ) {
+        D = *(dataArray->GetElementPtr(i));
+        if ( strcmp(D->GetName(),Name)==0 )
+            return 1;
+    }
+    return 0;
+}
+
 int   InputData::GetIntVal(char* Name
 #ifdef _MPI
                            ,int rank
@@ -1676,6 +1688,114 @@ FP  InputData::GetVal(char* Name, FP par
     return 0.;
 }
 
+static int CmpFP(const void* a, const void* b) {
+    if ( *(FP*)a < *(FP*)b ) return -1;
+    if ( *(FP*)a > *(FP*)b ) return  1;
+    return 0;
+}
+
+TableSet::TableSet(Table** tables, unsigned int n) {
+    unsigned int i, k, t, nx = 0;
+
+    nt       = n;
+    m        = 0;
+    pT       = new Table*[nt];
+    isMerged = new int[nt];
+
+    for ( t=0; t<nt; t++ ) {
+        pT[t]       = tables[t];
+        isMerged[t] = 1;
+        nx         += pT[t]->n;
+    }
+
+    xm = new FP[nx+1];
+
+    for ( t=0; t<nt; t++ ) {
+        if ( pT[t]->n < 2 )
+            continue;
+        for ( i=0; i<pT[t]->n; i++ )
+            xm[m++] = pT[t]->x[i];
+    }
+
+    qsort(xm,m,sizeof(FP),CmpFP);
+
+    for ( i=0, k=0; i<m; i++ )
+        if ( k == 0 || xm[i] != xm[k-1] )
+            xm[k++] = xm[i];
+    m = k;
+
+    C = new FP[(m+1)*nt*4];
+
+    for ( k=0; k<=m; k++ ) {
+        for ( t=0; t<nt; t++ ) {
+            Table* T = pT[t];
+            FP*    c = C + (k*nt+t)*4;
+            if ( T->n < 2 ) {
+                c[0] = 0.;
+                c[1] = ( T->n == 1 ) ? T->y[0] : 0.;
+                c[2] = 0.;
+                c[3] = 1.;
+                continue;
+            }
+            // interval of table is same for all x in (xm[k-1],xm[k]),
+            // table is not merged if it differ in xm[k-1]
+            if ( k == 0 ) {
+                i = T->GetInterval(xm[0]-1.);
+            } else if ( k == m ) {
+                i = T->GetInterval(xm[m-1]+1.);
+            } else {
+                i = T->GetInterval(0.5*(xm[k-1]+xm[k]));
+            }
+            if ( k > 0 && T->GetInterval(xm[k-1]) != i )
+                isMerged[t] = 0;
+            c[0] = T->x[i];
+            c[1] = T->y[i];
+            c[2] = T->y[i-1] - T->y[i];
+            c[3] = T->x[i-1] - T->x[i];
+        }
+    }
+}
+
+TableSet::~TableSet() {
+    delete [] pT;
+    delete [] isMerged;
+    delete [] xm;
+    delete [] C;
+}
+
+unsigned int TableSet::GetInterval(FP _x, unsigned int* hint) {
+    unsigned int lo = 0, hi = m;
+
+    // merged grid interval xm[lo-1] <= _x < xm[lo]
+    if ( hint && *hint <= m &&
+         (*hint == 0 || xm[*hint-1] <= _x) && (*hint == m || _x < xm[*hint]) ) {
+        return *hint;
+    }
+
+    while ( lo < hi ) {
+        unsigned int mid = (lo+hi)/2;
+        if ( _x < xm[mid] )
+            hi = mid;
+        else
+            lo = mid+1;
+    }
+    if ( hint )
+        *hint = lo;
+    return lo;
+}
+
+void TableSet::GetVal(FP _x, FP* val, unsigned int n_val, unsigned int* hint) {
+    const FP* c = C + GetInterval(_x,hint)*nt*4;
+
+    // same expression as in Table::GetVal()
+    for ( unsigned int t=0; t<n_val; t++, c+=4 ) {
+        if ( isMerged[t] )
+            val[t] = c[1] + c[2]*(_x - c[0])/c[3];
+        else
+            val[t] = pT[t]->GetVal(_x);
+    }
+}
+
 Table* InputData::zeroTable = new Table((char*)"ZeroTable",0);
 
 Table*  InputData::GetZeroTable() {
@@ -1819,35 +1939,37 @@ int    Table::operator  < (Table) {
     return 0;
 }
 
-FP Table::GetVal(FP _x ) {
-    if ( this == InputData::GetZeroTable() )
-        return 0.;
-    //
-    register int    i, _n = n;
-    register FP _y;
-
-    //
-    if ( _n == 1 )
-        return( y[0] );
+// Interval i (1...n-1) of table for GetVal(), n > 1
+unsigned int Table::GetInterval(FP _x ) {
+    unsigned int i, _n = n;
 
     //
-    if ( _x <= x[0] ) {
-        i = 1;
-        goto EndGetVal;
-    }
+    if ( _x <= x[0] )
+        return 1;
 
     //
-    if ( _x >= x[n-1] ) {
-        i = _n - 1;
-        goto EndGetVal;
-    }
+    if ( _x >= x[n-1] )
+        return _n - 1;
 
     for ( i=1; i<_n; i++ ) {
         if ( (_x >= x[i-1]) && (_x < x[i]) )
             break;
     }
+    return i;
+}
 
-    EndGetVal:
+FP Table::GetVal(FP _x ) {
+    if ( this == InputData::GetZeroTable() )
+        return 0.;
+    //
+    register int    i;
+    register FP _y;
+
+    //
+    if ( n == 1 )
+        return( y[0] );
+
+    i = GetInterval(_x);
 
     _y = y[i] + (y[i-1] - y[i])*(_x - x[i])/(x[i-1] - x[i]);
 
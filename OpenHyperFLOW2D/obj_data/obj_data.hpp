@@ -146,10 +146,43 @@ Table(char* name ,int N);
 char*  GetName();
 void   SetName(char*);
 FP GetVal(FP _x );
+unsigned int GetInterval(FP _x ); // interval i (x[i-1]...x[i]) used by GetVal()
 int    operator  > (Table);
 int    operator  < (Table);
 };
 
+// Set of tables evaluated at same x by one search.
+// x points of all tables are merged into one grid, for every interval
+// of merged grid end points of source table interval are stored
+// (same intervals and same expression as in Table::GetVal(), so
+// results are equal to Table::GetVal() bit by bit).
+// Tables with interval not constant on merged grid interval
+// are evaluated by Table::GetVal().
+class TableSet
+{
+ unsigned int    nt;     // number of tables
+ unsigned int    m;      // number of merged grid points
+ FP*             xm;     // merged grid
+ FP*             C;      // C[(k*nt+t)*4] - x[i], y[i], y[i-1]-y[i], x[i-1]-x[i] of table t for xm[k-1] <= x < xm[k]
+ Table**         pT;
+ int*            isMerged; // isMerged[t] - 0 if table t is evaluated by Table::GetVal()
+
+public:
+
+TableSet(Table** tables, unsigned int n);
+~TableSet();
+unsigned int GetNumTables() {return nt;}
+// val[t] for first n_val tables, hint - last merged grid interval (optional)
+void   GetVal(FP _x, FP* val, unsigned int n_val, unsigned int* hint = NULL);
+// merged grid interval of _x (for GetVal(_x,k,t))
+unsigned int GetInterval(FP _x, unsigned int* hint = NULL);
+// value of table t in merged grid interval k
+FP     GetVal(FP _x, unsigned int k, unsigned int t) {
+       const FP* c = C + (k*nt+t)*4;
+       return isMerged[t] ? c[1] + c[2]*(_x - c[0])/c[3] : pT[t]->GetVal(_x);
+}
+};
+
 enum DATA_SOURCE {
                   DS_FILE,
                   DS_MEM,
@@ -206,6 +239,7 @@ public:
  DATA_SOURCE GetDataSource();
  int         GetDataError();
  char*       GetDataName();
+ int         CheckData(char* Name);
  
  ostream*    GetMessageStream();
  void        SetMessageStream(ostream*);
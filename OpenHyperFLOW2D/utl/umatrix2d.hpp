@@ -12,6 +12,7 @@
 #include "utl/locker.hpp"
 #define UTL_PAGE_SIZE 1024*1024*1024
 #undef _SAFE_ACCESS_
+// _UMATRIX_CHECK_ACCESS_ - check index of every UMatrixView2D access (debug)
 // Common 2D/3D types
 // Matrix type
 enum MatrixType {
@@ -85,11 +86,14 @@ public:
     unsigned int  GetY()             {return nY;}
     MatrixState   GetMatrixState()   {return ms;}
     MatrixType    GetMatrixType()    {return mt;}
+    MatrixStorageOrder2D GetStorageOrder() {return mso;}
     T*            GetMatrixPtr()     {return Ptr;}
     void          SetMatrixPtr(T* x) {Ptr=x;}
     T& operator   () (unsigned int,unsigned int);
     UMatrix2D<T>&   operator  = (UMatrix2D<T>&);
     T&            GetValue(unsigned int,unsigned int);
+    void          CheckRange(unsigned int,unsigned int,unsigned int,unsigned int);
+    void          CheckIndex(ssize_t);
     ssize_t       GetMatrixSize()    {return nX*nY*sizeof(T);}
 
     ssize_t  GetRowSize() {
@@ -240,4 +244,112 @@ inline T& UMatrix2D<T>::GetValue(unsigned int x,unsigned int y)
         return Ptr[x*nY + y];
     //  return Ptr[ATF(x,y,atfN)]; 
 }
+
+// Check x0 <= x < x1, y0 <= y < y1 (once per sweep)
+template <class T>
+inline void UMatrix2D<T>::CheckRange(unsigned int x0,unsigned int x1,unsigned int y0,unsigned int y1)
+{
+    if(x0>x1 || x1>nX) {
+        ms=MXS_ERR_OUT_OF_INDEX;throw(this);
+    } else if(y0>y1 || y1>nY) {
+        ms=MXS_ERR_OUT_OF_INDEX;throw(this);
+    } else ms = MXS_OK;
+}
+
+// Check linear index of element
+template <class T>
+inline void UMatrix2D<T>::CheckIndex(ssize_t n)
+{
+    if(n<0 || n>=(ssize_t)nX*nY) {
+        ms=MXS_ERR_OUT_OF_INDEX;throw(this);
+    } else ms = MXS_OK;
+}
+
+// Linear indexes of node (x,y) and its neighbors
+struct UStencil2D {
+    ssize_t C;  // (x,y)
+    ssize_t L;  // (x-1,y)
+    ssize_t R;  // (x+1,y)
+    ssize_t U;  // (x,y+1)
+    ssize_t D;  // (x,y-1)
+};
+
+// Stencil view of UMatrix2D for hot loops: raw pointer, strides and
+// neighbor indexes without per-access checks. Caller checks range of
+// sweep once by CheckRange(), _UMATRIX_CHECK_ACCESS_ enables per-access checks.
+template <class T>
+class UMatrixView2D
+{
+    T*             Ptr;
+    UMatrix2D<T>*  M;
+    unsigned int   nX;
+    unsigned int   nY;
+    ssize_t        sX;   // stride of x
+    ssize_t        sY;   // stride of y
+
+public:
+    UMatrixView2D(UMatrix2D<T>* m) {
+        M   = m;
+        Ptr = m->GetMatrixPtr();
+        nX  = m->GetX();
+        nY  = m->GetY();
+        if(m->GetStorageOrder() == MSO_XY) {
+            sX = 1;
+            sY = nX;
+        } else {
+            sX = nY;
+            sY = 1;
+        }
+    }
+
+    inline unsigned int  GetX()          {return nX;}
+    inline unsigned int  GetY()          {return nY;}
+    inline ssize_t       GetStrideX()    {return sX;}
+    inline ssize_t       GetStrideY()    {return sY;}
+    inline T*            GetMatrixPtr()  {return Ptr;}
+    inline UMatrix2D<T>* GetMatrix()     {return M;}
+
+    inline void CheckRange(unsigned int x0,unsigned int x1,unsigned int y0,unsigned int y1) {
+        M->CheckRange(x0,x1,y0,y1);
+    }
+
+    inline ssize_t Index(unsigned int x,unsigned int y) {
+#ifdef _UMATRIX_CHECK_ACCESS_
+        M->CheckRange(x,x+1,y,y+1);
+#endif // _UMATRIX_CHECK_ACCESS_
+        return x*sX + y*sY;
+    }
+
+    inline T& operator [] (ssize_t n) {
+#ifdef _UMATRIX_CHECK_ACCESS_
+        M->CheckIndex(n);
+#endif // _UMATRIX_CHECK_ACCESS_
+        return Ptr[n];
+    }
+
+    inline T& operator () (unsigned int x,unsigned int y) {
+        return Ptr[Index(x,y)];
+    }
+
+    // Neighbors with given distances (0 or 1) in each direction,
+    // absent neighbor (distance 0) is node itself
+    inline void Stencil(ssize_t n, int dXl, int dXr, int dYu, int dYd, UStencil2D* s) {
+        s->C = n;
+        s->L = n - dXl*sX;
+        s->R = n + dXr*sX;
+        s->U = n + dYu*sY;
+        s->D = n - dYd*sY;
+#ifdef _UMATRIX_CHECK_ACCESS_
+        M->CheckIndex(s->L);
+        M->CheckIndex(s->R);
+        M->CheckIndex(s->U);
+        M->CheckIndex(s->D);
+#endif // _UMATRIX_CHECK_ACCESS_
+    }
+
+    // Neighbors inside matrix (node itself at matrix edge)
+    inline void Stencil(unsigned int x, unsigned int y, UStencil2D* s) {
+        Stencil(Index(x,y),x > 0,x+1 < nX,y+1 < nY,y > 0,s);
+    }
+};
 #endif  // _umatrix2d_hpp_